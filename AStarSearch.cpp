@@ -0,0 +1,45 @@
+#include "AStarSearch.h"
+
+#include <algorithm>
+
+void AStarSearch::reset(const int vertexCount)
+{
+    stamps.reset(vertexCount);
+    queue.clear();
+    if (times.size() < stamps.size())
+    {
+        times.resize(stamps.size());
+        bounds.resize(stamps.size());
+        parents.resize(stamps.size());
+    }
+
+    target = -1;
+    settledCount = 0;
+}
+
+std::uint64_t AStarSearch::timeOf(const int vertex) const
+{
+    return stamps.isMarked(vertex) ? times[vertex] : ShortestPathTree::UNREACHABLE;
+}
+
+int AStarSearch::getSettledCount() const
+{
+    return settledCount;
+}
+
+void AStarSearch::getRoute(std::vector<int>& route) const
+{
+    route.clear();
+    if (target == -1 || timeOf(target) == ShortestPathTree::UNREACHABLE)
+        return;
+
+    for (int v = target; v != -1; v = parents[v])
+        route.push_back(v);
+    std::reverse(route.begin(), route.end());
+}
+
+AStarSearch& AStarSearch::local()
+{
+    thread_local AStarSearch search;
+    return search;
+}
@@ -0,0 +1,121 @@
+#ifndef ASTARSEARCH_H
+#define ASTARSEARCH_H
+
+#include <cstdint>
+#include <vector>
+
+#include "EpochStamps.h"
+#include "LandmarkIndex.h"
+#include "RadixHeap.h"
+#include "ShortestPathTree.h"
+
+/**
+ * Point-to-point shortest travel time by A* search, guided by the lower bounds of a
+ * <i>LandmarkIndex</i> (ALT). Vertices are settled in order of travel time plus the bound to the
+ * target, so the search heads for the target and stops as soon as it is settled. The bounds are
+ * consistent, which keeps the queue keys monotone and lets a <i>RadixHeap</i> order them; vertices
+ * the landmarks show cannot reach the target are left out.
+ * Scratch buffers are kept between queries and reset by epoch stamps, so repeated queries
+ * on one graph do not allocate; use one instance per thread, e.g. <i>local()</i>.
+ */
+class AStarSearch
+{
+private:
+    RadixHeap queue; /* Keyed by travel time plus the bound to the target */
+    std::vector<std::uint64_t> times; /* Tentative travel times, valid where stamped */
+    std::vector<std::uint64_t> bounds; /* Lower bound to the target, valid where stamped */
+    std::vector<int> parents; /* Previous vertex on the route from the source, valid where stamped */
+    EpochStamps stamps; /* The vertices reached by the current query */
+    int target{-1};
+    int settledCount{0};
+
+    void reset(int vertexCount);
+
+    std::uint64_t timeOf(int vertex) const;
+
+public:
+    AStarSearch() = default;
+    ~AStarSearch() = default;
+    AStarSearch(const AStarSearch& other) = default;
+    AStarSearch(AStarSearch&& other) noexcept = default;
+    AStarSearch& operator=(const AStarSearch& other) = default;
+    AStarSearch& operator=(AStarSearch&& other) noexcept = default;
+
+    /**
+     * Finds the shortest travel time from <i>source</i> to <i>target</i>.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>
+     * with unsigned integer weights.
+     * @param graph The graph to search.
+     * @param landmarks Distance tables built from <i>graph</i>.
+     * @param source A valid vertex index.
+     * @param target A valid vertex index.
+     * @return The travel time, <i>ShortestPathTree::UNREACHABLE</i> if there is no route.
+     */
+    template <class GraphType>
+    std::uint64_t run(const GraphType& graph, const LandmarkIndex& landmarks, int source, int target);
+
+    /**
+     * @return The number of vertices the last query settled, the measure of its search space.
+     */
+    int getSettledCount() const;
+
+    /**
+     * Fills <i>route</i> with the vertex indexes of the last query's route, source first;
+     * empty if there was none.
+     * @param route Output parameter, cleared first.
+     */
+    void getRoute(std::vector<int>& route) const;
+
+    /**
+     * @return The calling thread's instance.
+     */
+    static AStarSearch& local();
+};
+
+template <class GraphType>
+std::uint64_t AStarSearch::run(const GraphType& graph, const LandmarkIndex& landmarks, const int source,
+                               const int target)
+{
+    reset(graph.vertexCount());
+    this->target = target;
+
+    stamps.mark(source);
+    times[source] = 0;
+    bounds[source] = landmarks.lowerBound(source, target);
+    parents[source] = -1;
+    if (bounds[source] == ShortestPathTree::UNREACHABLE)
+        return ShortestPathTree::UNREACHABLE;
+    queue.push(bounds[source], source);
+
+    while (!queue.isEmpty())
+    {
+        const auto [key, u] = queue.pop();
+        if (key != times[u] + bounds[u])
+            continue; // Stale entry
+
+        ++settledCount;
+        if (u == target)
+            return times[u];
+
+        graph.forEachOutEdge(u, [&](const int neighbor, const auto& weight)
+        {
+            const std::uint64_t arrival = times[u] + weight;
+            if (stamps.mark(neighbor))
+            {
+                times[neighbor] = ShortestPathTree::UNREACHABLE;
+                bounds[neighbor] = landmarks.lowerBound(neighbor, target);
+            }
+            // A vertex that cannot reach the target is never queued
+            if (arrival < times[neighbor] && bounds[neighbor] != ShortestPathTree::UNREACHABLE)
+            {
+                times[neighbor] = arrival;
+                parents[neighbor] = u;
+                queue.push(arrival + bounds[neighbor], neighbor);
+            }
+        });
+    }
+
+    return ShortestPathTree::UNREACHABLE;
+}
+
+#endif //ASTARSEARCH_H
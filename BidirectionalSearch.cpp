@@ -0,0 +1,49 @@
+#include "BidirectionalSearch.h"
+
+#include <algorithm>
+
+void BidirectionalSearch::reset(const int vertexCount)
+{
+    for (Side* side : {&forward, &backward})
+    {
+        side->stamps.reset(vertexCount);
+        side->queue.clear();
+        if (side->times.size() < side->stamps.size())
+        {
+            side->times.resize(side->stamps.size());
+            side->parents.resize(side->stamps.size());
+            side->settled.resize(side->stamps.size());
+        }
+    }
+
+    meetingFrom = meetingTo = -1;
+    best = ShortestPathTree::UNREACHABLE;
+}
+
+std::uint64_t BidirectionalSearch::timeOf(const Side& side, const int vertex) const
+{
+    return side.stamps.isMarked(vertex) ? side.times[vertex] : ShortestPathTree::UNREACHABLE;
+}
+
+void BidirectionalSearch::getRoute(std::vector<int>& route) const
+{
+    route.clear();
+    if (best == ShortestPathTree::UNREACHABLE)
+        return;
+
+    for (int v = meetingFrom; v != -1; v = forward.parents[v])
+        route.push_back(v);
+    std::reverse(route.begin(), route.end());
+
+    if (meetingTo != meetingFrom)
+    {
+        for (int v = meetingTo; v != -1; v = backward.parents[v])
+            route.push_back(v);
+    }
+}
+
+BidirectionalSearch& BidirectionalSearch::local()
+{
+    thread_local BidirectionalSearch search;
+    return search;
+}
@@ -0,0 +1,156 @@
+#ifndef BIDIRECTIONALSEARCH_H
+#define BIDIRECTIONALSEARCH_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "EpochStamps.h"
+#include "RadixHeap.h"
+#include "ShortestPathTree.h"
+
+/**
+ * Point-to-point shortest travel time by bidirectional Dijkstra: one search forward over
+ * out-edges from the source, one backward over in-edges from the target, always advancing
+ * the side whose queue has the smaller minimum. The search stops once the two minimums add
+ * up to at least the best route found through an edge joining the two sides.
+ * Scratch buffers are kept between queries and reset by epoch stamps, so repeated queries
+ * on one graph do not allocate; use one instance per thread, e.g. <i>local()</i>.
+ */
+class BidirectionalSearch
+{
+private:
+    /**
+     * One direction's search state
+     */
+    struct Side
+    {
+        RadixHeap queue;
+        std::vector<std::uint64_t> times; /* Tentative travel times, valid where stamped */
+        std::vector<int> parents; /* Previous vertex on the route from this side's root, valid where stamped */
+        EpochStamps stamps; /* The vertices this side reached in the current query */
+        std::vector<bool> settled; /* Valid where stamped */
+    };
+
+    Side forward;
+    Side backward;
+    int meetingFrom{-1}; /* Best route so far uses the edge meetingFrom -> meetingTo */
+    int meetingTo{-1};
+    std::uint64_t best{ShortestPathTree::UNREACHABLE};
+
+    void reset(int vertexCount);
+
+    std::uint64_t timeOf(const Side& side, int vertex) const;
+
+    /**
+     * Settles the vertex with the smallest time on <i>self</i>, relaxing its edges in that direction.
+     */
+    template <bool Forward, class GraphType>
+    void advance(const GraphType& graph, Side& self, const Side& other);
+
+public:
+    BidirectionalSearch() = default;
+    ~BidirectionalSearch() = default;
+    BidirectionalSearch(const BidirectionalSearch& other) = default;
+    BidirectionalSearch(BidirectionalSearch&& other) noexcept = default;
+    BidirectionalSearch& operator=(const BidirectionalSearch& other) = default;
+    BidirectionalSearch& operator=(BidirectionalSearch&& other) noexcept = default;
+
+    /**
+     * Finds the shortest travel time from <i>source</i> to <i>target</i>.
+     * @tparam GraphType Provides <i>vertexCount()</i>, <i>forEachOutEdge(index, visit)</i> and
+     * <i>forEachInEdge(index, visit)</i> with unsigned integer weights.
+     * @param graph The graph to search.
+     * @param source A valid vertex index.
+     * @param target A valid vertex index.
+     * @return The travel time, <i>ShortestPathTree::UNREACHABLE</i> if there is no route.
+     */
+    template <class GraphType>
+    std::uint64_t run(const GraphType& graph, int source, int target);
+
+    /**
+     * Fills <i>route</i> with the vertex indexes of the last query's route, source first;
+     * empty if there was none.
+     * @param route Output parameter, cleared first.
+     */
+    void getRoute(std::vector<int>& route) const;
+
+    /**
+     * @return The calling thread's instance.
+     */
+    static BidirectionalSearch& local();
+};
+
+template <bool Forward, class GraphType>
+void BidirectionalSearch::advance(const GraphType& graph, Side& self, const Side& other)
+{
+    const auto [time, u] = self.queue.pop();
+    if (self.settled[u])
+        return; // Stale entry
+    self.settled[u] = true;
+
+    const auto relax = [&](const int neighbor, const auto& weight)
+    {
+        const std::uint64_t arrival = time + weight;
+        if (arrival < timeOf(self, neighbor))
+        {
+            if (self.stamps.mark(neighbor))
+                self.settled[neighbor] = false;
+            self.times[neighbor] = arrival;
+            self.parents[neighbor] = u;
+            self.queue.push(arrival, neighbor);
+        }
+
+        const std::uint64_t rest = timeOf(other, neighbor);
+        if (rest != ShortestPathTree::UNREACHABLE && arrival + rest < best)
+        {
+            best = arrival + rest;
+            meetingFrom = Forward ? u : neighbor;
+            meetingTo = Forward ? neighbor : u;
+        }
+    };
+
+    if constexpr (Forward)
+        graph.forEachOutEdge(u, relax);
+    else
+        graph.forEachInEdge(u, relax);
+}
+
+template <class GraphType>
+std::uint64_t BidirectionalSearch::run(const GraphType& graph, const int source, const int target)
+{
+    reset(graph.vertexCount());
+
+    for (auto [side, root] : {std::pair{&forward, source}, std::pair{&backward, target}})
+    {
+        side->stamps.mark(root);
+        side->times[root] = 0;
+        side->parents[root] = -1;
+        side->settled[root] = false;
+        side->queue.push(0, root);
+    }
+
+    if (source == target)
+    {
+        best = 0;
+        meetingFrom = meetingTo = source;
+        return best;
+    }
+
+    while (!forward.queue.isEmpty() && !backward.queue.isEmpty())
+    {
+        const std::uint64_t forwardMin = forward.queue.topKey();
+        const std::uint64_t backwardMin = backward.queue.topKey();
+        if (best != ShortestPathTree::UNREACHABLE && forwardMin + backwardMin >= best)
+            break;
+
+        if (forwardMin <= backwardMin)
+            advance<true>(graph, forward, backward);
+        else
+            advance<false>(graph, backward, forward);
+    }
+
+    return best;
+}
+
+#endif //BIDIRECTIONALSEARCH_H
@@ -0,0 +1,27 @@
+#include "Checksum.h"
+
+#include <cstring>
+
+std::uint64_t checksum(const std::string_view bytes)
+{
+    constexpr std::uint64_t PRIME = 0x100000001b3;
+    std::uint64_t lanes[4] = {0xcbf29ce484222325, 0x84222325cbf29ce4, 0xcbf29ce4cbf29ce4, 0x8422232584222325};
+
+    std::size_t i = 0;
+    for (; i + sizeof(lanes) <= bytes.size(); i += sizeof(lanes))
+    {
+        for (int lane = 0; lane < 4; ++lane)
+        {
+            std::uint64_t word;
+            std::memcpy(&word, bytes.data() + i + lane * sizeof(word), sizeof(word));
+            lanes[lane] = (lanes[lane] ^ word) * PRIME;
+        }
+    }
+
+    std::uint64_t hash = bytes.size();
+    for (const std::uint64_t lane : lanes)
+        hash = (hash ^ lane) * PRIME;
+    for (; i < bytes.size(); ++i)
+        hash = (hash ^ static_cast<unsigned char>(bytes[i])) * PRIME;
+    return hash;
+}
@@ -0,0 +1,17 @@
+#ifndef CHECKSUM_H
+#define CHECKSUM_H
+
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Checksum of the binary files the graph saves, to reject a corrupted or truncated file before
+ * any of it is trusted. 64-bit FNV-1a over 8-byte words, in four interleaved lanes so the
+ * multiplications overlap. Every step is a bijection of the lane, so changing any one word
+ * always changes the result. It detects accidents, not tampering.
+ * @param bytes The bytes to sum.
+ * @return The checksum.
+ */
+std::uint64_t checksum(std::string_view bytes);
+
+#endif //CHECKSUM_H
@@ -0,0 +1,461 @@
+#ifndef COMPACTGRAPH_H
+#define COMPACTGRAPH_H
+
+#include <concepts>
+#include <iostream>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "DirectionOptimizingBFS.h"
+#include "GraphSnapshot.h"
+#include "ParallelBFS.h"
+#include "TraversalWorkspace.h"
+#include "VertexNotFoundException.h"
+
+using namespace std;
+
+/**
+ * An immutable directed graph, stored in compressed-sparse-row (CSR) form.
+ * The out-edges of vertex <i>i</i> are <i>neighbors[offsets[i]..offsets[i + 1])</i>,
+ * with matching <i>weights</i>, sorted by neighbor index.
+ * A transposed copy (<i>reverseOffsets</i>, <i>reverseSources</i>, <i>reverseWeights</i>)
+ * holds the in-edges the same way, sorted by source index.
+ * Built by <i>Graph::freeze()</i> for read-only query serving: traversals cost O(V+E)
+ * instead of scanning a full matrix row per vertex.
+ * The arrays are views into shared, immutable storage: either arrays built in memory or a mapped
+ * <i>GraphSnapshot</i> file, used in place. Copies share that storage.
+ * @tparam VertexType The vertex type. Same requirements as in <i>Graph</i>.
+ * @tparam Weight The weight type. Same requirements as in <i>Graph</i>.
+ */
+template <class VertexType, class Weight>
+class CompactGraph
+{
+private:
+    /**
+     * The CSR arrays of a graph built in memory
+     */
+    struct Arrays
+    {
+        vector<int> offsets;
+        vector<int> neighbors;
+        vector<Weight> weights;
+        vector<int> reverseOffsets;
+        vector<int> reverseSources;
+        vector<Weight> reverseWeights;
+    };
+
+    vector<VertexType> vertices; /* The vertices, by index */
+    unordered_map<VertexType, int> indexes; /* Maps each vertex to its index */
+    shared_ptr<const void> storage; /* Owns the arrays below: an Arrays or a GraphSnapshot */
+    span<const int> offsets; /* Start of each vertex's out-edges in neighbors, plus a trailing end offset */
+    span<const int> neighbors; /* Out-edge targets, grouped by source */
+    span<const Weight> weights; /* Out-edge weights, parallel to neighbors */
+    span<const int> reverseOffsets; /* Start of each vertex's in-edges in reverseSources, plus a trailing end offset */
+    span<const int> reverseSources; /* In-edge sources, grouped by target */
+    span<const Weight> reverseWeights; /* In-edge weights, parallel to reverseSources */
+
+    /**
+     * Maps every vertex to its index.
+     */
+    void indexVertices();
+
+    /**
+     * Breadth-first search from <i>start</i>, in the calling thread's <i>TraversalWorkspace</i>.
+     * Direction-optimizing, by <i>DirectionOptimizingBFS</i> over the sorted CSR arrays.
+     * @param start A valid vertex index.
+     * @param reverse Follow in-edges instead of out-edges.
+     * @return The workspace's <i>order</i>: reached vertices, <i>start</i> first. Valid until the next traversal.
+     */
+    const vector<int>& performBFS(int start, bool reverse = false) const;
+
+    /**
+     * Breadth-first search from <i>start</i> on <i>threadCount</i> threads, by <i>ParallelBFS</i>.
+     * @param start A valid vertex index.
+     * @param threadCount Number of threads to use, at least 1.
+     * @return The calling thread's <i>TraversalWorkspace</i> <i>order</i>: reached vertices, level by level,
+     * <i>start</i> first. Valid until the next traversal.
+     */
+    const vector<int>& performParallelBFS(int start, unsigned int threadCount) const;
+
+    /**
+     * Depth-first search from <i>start</i>, in the calling thread's <i>TraversalWorkspace</i>.
+     * Iterative: each stack frame keeps a cursor to its vertex's next out-edge, so every edge
+     * is examined once and call-stack depth stays constant however long the path.
+     * @param start A valid vertex index.
+     * @return The workspace's <i>order</i>: reached vertices, <i>start</i> first. Valid until the next traversal.
+     */
+    const vector<int>& performDFS(int start) const;
+
+public:
+    CompactGraph() = default;
+    CompactGraph(const CompactGraph& other) = default;
+    CompactGraph(CompactGraph&& other) noexcept = default;
+    CompactGraph& operator=(const CompactGraph& other) = default;
+    CompactGraph& operator=(CompactGraph&& other) noexcept = default;
+
+    /**
+     * Builds a graph from CSR arrays, and derives the transposed arrays from them.
+     * @param vertices The vertices, by index.
+     * @param offsets <i>vertices.size() + 1</i> offsets into <i>neighbors</i>.
+     * @param neighbors Out-edge targets, grouped by source and sorted within each group.
+     * @param weights Out-edge weights, parallel to <i>neighbors</i>.
+     */
+    CompactGraph(vector<VertexType> vertices, vector<int> offsets, vector<int> neighbors, vector<Weight> weights);
+
+    /**
+     * Loads a graph saved by <i>saveSnapshot</i>. The file is memory-mapped and its arrays used in place,
+     * so loading costs one pass over the file for the checksum and bounds checks, plus one vertex
+     * table entry per vertex, and nothing per edge.
+     * @param fileName The snapshot file.
+     * @return The saved graph.
+     * @throws std::invalid_argument If the file cannot be read or is not a valid snapshot of this graph type.
+     */
+    static CompactGraph loadSnapshot(const string& fileName)
+        requires same_as<VertexType, string> && is_trivially_copyable_v<Weight>;
+
+    /**
+     * Saves the graph as a <i>GraphSnapshot</i> file, for <i>loadSnapshot</i>.
+     * @param fileName The file to write.
+     * @throws std::invalid_argument If the file cannot be written.
+     */
+    void saveSnapshot(const string& fileName) const
+        requires same_as<VertexType, string> && is_trivially_copyable_v<Weight>;
+
+    /**
+     * @return The number of vertices; valid indexes are <i>0..vertexCount() - 1</i>.
+     */
+    int vertexCount() const;
+
+    /**
+     * Retrieves the index of <i>vertex</i>
+     * @param vertex Vertex to get the index to
+     * @return the index of <i>vertex</i>
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    int getIndexForVertex(const VertexType& vertex) const;
+
+    /**
+     * Retrieves the vertex stored at <i>index</i>.
+     * @param index A valid vertex index.
+     * @return The vertex at <i>index</i>.
+     */
+    const VertexType& getVertex(int index) const;
+
+    /**
+     * Calls <i>visit(neighborIndex, weight)</i> for every out-edge of the vertex at <i>index</i>,
+     * by ascending neighbor index. Does not allocate.
+     * @param index A valid vertex index.
+     * @param visit Callable taking <i>(int, const Weight&)</i>.
+     */
+    template <class Visitor>
+    void forEachOutEdge(int index, Visitor&& visit) const;
+
+    /**
+     * Calls <i>visit(sourceIndex, weight)</i> for every in-edge of the vertex at <i>index</i>,
+     * by ascending source index. Does not allocate.
+     * @param index A valid vertex index.
+     * @param visit Callable taking <i>(int, const Weight&)</i>.
+     */
+    template <class Visitor>
+    void forEachInEdge(int index, Visitor&& visit) const;
+
+    /**
+     * Retrieves all vertices that can be reached directly from <i>vertex</i>.
+     * @param vertex The vertex whose direct neighbors should be retrieved.
+     * @return A vector of vertices that <i>vertex</i> has direct edges to.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    vector<VertexType> getDirectNeighbors(const VertexType& vertex) const;
+
+    /**
+     * Retrieves all vertices that can be reached from <i>vertex</i> using any number of edges.
+     * @param vertex The starting vertex for the search.
+     * @param useBFS Search breadth-first if <i>true</i>, depth-first otherwise.
+     * @param threadCount Number of threads for a breadth-first search, as in <i>Graph::getConnections</i>.
+     * @return A vector of all reachable vertices, in the same order as <i>Graph::getConnections</i>.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    vector<VertexType> getConnections(const VertexType& vertex, bool useBFS = true, unsigned int threadCount = 1) const;
+
+    /**
+     * Retrieves all vertices that have a direct edge to <i>vertex</i>, in O(in-degree).
+     * @param vertex The target vertex.
+     * @return A vector of vertices that directly point to <i>vertex</i>.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    vector<VertexType> getDirectSources(const VertexType& vertex) const;
+
+    /**
+     * Retrieves all vertices that can reach <i>vertex</i> using any number of edges,
+     * by a breadth-first search over in-edges.
+     * @param vertex The target vertex for the search.
+     * @return A vector of all vertices that reach <i>vertex</i>, in the same order as <i>Graph::getReverseConnections</i>.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    vector<VertexType> getReverseConnections(const VertexType& vertex) const;
+
+    /**
+     * Print vertex: vertex vertex
+     */
+    void print() const;
+};
+
+
+// Implementation
+
+template <class VertexType, class Weight>
+CompactGraph<VertexType, Weight>::CompactGraph(vector<VertexType> vertices, vector<int> offsets,
+                                               vector<int> neighbors, vector<Weight> weights)
+    : vertices(move(vertices))
+{
+    indexVertices();
+
+    const auto arrays = make_shared<Arrays>();
+    arrays->offsets = move(offsets);
+    arrays->neighbors = move(neighbors);
+    arrays->weights = move(weights);
+
+    // Transpose by counting sort on the target; sources are scanned in ascending order,
+    // so each in-edge group comes out sorted by source.
+    arrays->reverseOffsets.assign(this->vertices.size() + 1, 0);
+    for (const int target : arrays->neighbors)
+        ++arrays->reverseOffsets[target + 1];
+    for (size_t i = 1; i < arrays->reverseOffsets.size(); ++i)
+        arrays->reverseOffsets[i] += arrays->reverseOffsets[i - 1];
+
+    arrays->reverseSources.resize(arrays->neighbors.size());
+    arrays->reverseWeights.resize(arrays->neighbors.size());
+    vector<int> next(arrays->reverseOffsets.begin(), arrays->reverseOffsets.end() - 1);
+    for (int source = 0; source < vertexCount(); ++source)
+    {
+        for (int e = arrays->offsets[source]; e < arrays->offsets[source + 1]; ++e)
+        {
+            const int slot = next[arrays->neighbors[e]]++;
+            arrays->reverseSources[slot] = source;
+            arrays->reverseWeights[slot] = arrays->weights[e];
+        }
+    }
+
+    this->offsets = arrays->offsets;
+    this->neighbors = arrays->neighbors;
+    this->weights = arrays->weights;
+    reverseOffsets = arrays->reverseOffsets;
+    reverseSources = arrays->reverseSources;
+    reverseWeights = arrays->reverseWeights;
+    storage = arrays;
+}
+
+template <class VertexType, class Weight>
+CompactGraph<VertexType, Weight> CompactGraph<VertexType, Weight>::loadSnapshot(const string& fileName)
+    requires same_as<VertexType, string> && is_trivially_copyable_v<Weight>
+{
+    const auto snapshot = make_shared<const GraphSnapshot>(fileName, sizeof(Weight));
+
+    CompactGraph graph;
+    graph.vertices.reserve(snapshot->vertexCount());
+    for (int i = 0; i < snapshot->vertexCount(); ++i)
+        graph.vertices.emplace_back(snapshot->getName(i));
+    graph.indexVertices();
+
+    graph.offsets = snapshot->getOffsets();
+    graph.neighbors = snapshot->getNeighbors();
+    graph.weights = snapshot->template getWeights<Weight>();
+    graph.reverseOffsets = snapshot->getReverseOffsets();
+    graph.reverseSources = snapshot->getReverseSources();
+    graph.reverseWeights = snapshot->template getReverseWeights<Weight>();
+    graph.storage = snapshot;
+    return graph;
+}
+
+template <class VertexType, class Weight>
+void CompactGraph<VertexType, Weight>::saveSnapshot(const string& fileName) const
+    requires same_as<VertexType, string> && is_trivially_copyable_v<Weight>
+{
+    // A default-constructed graph has no offsets at all; a snapshot always has the trailing one
+    const vector<int> noOffsets{0};
+    GraphSnapshot::save(fileName, vertices,
+                        offsets.empty() ? span<const int>(noOffsets) : offsets, neighbors, as_bytes(weights),
+                        reverseOffsets.empty() ? span<const int>(noOffsets) : reverseOffsets, reverseSources,
+                        as_bytes(reverseWeights), sizeof(Weight));
+}
+
+template <class VertexType, class Weight>
+void CompactGraph<VertexType, Weight>::indexVertices()
+{
+    indexes.reserve(vertices.size());
+    for (int i = 0; i < static_cast<int>(vertices.size()); ++i)
+        indexes.emplace(vertices[i], i);
+}
+
+template <class VertexType, class Weight>
+int CompactGraph<VertexType, Weight>::vertexCount() const
+{
+    return static_cast<int>(vertices.size());
+}
+
+template <class VertexType, class Weight>
+int CompactGraph<VertexType, Weight>::getIndexForVertex(const VertexType& vertex) const
+{
+    const auto it = indexes.find(vertex);
+    if (it == indexes.end())
+        throw VertexNotFoundException<VertexType>(vertex);
+    return it->second;
+}
+
+template <class VertexType, class Weight>
+const VertexType& CompactGraph<VertexType, Weight>::getVertex(const int index) const
+{
+    return vertices[index];
+}
+
+template <class VertexType, class Weight>
+template <class Visitor>
+void CompactGraph<VertexType, Weight>::forEachOutEdge(const int index, Visitor&& visit) const
+{
+    for (int e = offsets[index]; e < offsets[index + 1]; ++e)
+        visit(neighbors[e], weights[e]);
+}
+
+template <class VertexType, class Weight>
+template <class Visitor>
+void CompactGraph<VertexType, Weight>::forEachInEdge(const int index, Visitor&& visit) const
+{
+    for (int e = reverseOffsets[index]; e < reverseOffsets[index + 1]; ++e)
+        visit(reverseSources[e], reverseWeights[e]);
+}
+
+template <class VertexType, class Weight>
+vector<VertexType> CompactGraph<VertexType, Weight>::getDirectNeighbors(const VertexType& vertex) const
+{
+    const int index = getIndexForVertex(vertex);
+
+    vector<VertexType> directNeighbors;
+    directNeighbors.reserve(offsets[index + 1] - offsets[index]);
+    for (int e = offsets[index]; e < offsets[index + 1]; ++e)
+        directNeighbors.push_back(vertices[neighbors[e]]);
+
+    return directNeighbors;
+}
+
+template <class VertexType, class Weight>
+vector<VertexType> CompactGraph<VertexType, Weight>::getDirectSources(const VertexType& vertex) const
+{
+    const int index = getIndexForVertex(vertex);
+
+    vector<VertexType> directSources;
+    directSources.reserve(reverseOffsets[index + 1] - reverseOffsets[index]);
+    for (int e = reverseOffsets[index]; e < reverseOffsets[index + 1]; ++e)
+        directSources.push_back(vertices[reverseSources[e]]);
+
+    return directSources;
+}
+
+template <class VertexType, class Weight>
+vector<VertexType> CompactGraph<VertexType, Weight>::getReverseConnections(const VertexType& vertex) const
+{
+    const vector<int>& reached = performBFS(getIndexForVertex(vertex), true);
+
+    vector<VertexType> result;
+    result.reserve(reached.size() - 1);
+    for (auto it = reached.begin() + 1; it != reached.end(); ++it) // Skip the target vertex
+        result.push_back(vertices[*it]);
+    return result;
+}
+
+template <class VertexType, class Weight>
+vector<VertexType> CompactGraph<VertexType, Weight>::getConnections(const VertexType& vertex, bool useBFS,
+                                                                     const unsigned int threadCount) const
+{
+    const int start = getIndexForVertex(vertex);
+    const vector<int>& reached = !useBFS ? performDFS(start)
+                                 : threadCount > 1 ? performParallelBFS(start, threadCount) : performBFS(start);
+
+    vector<VertexType> result;
+    result.reserve(reached.size() - 1);
+    for (auto it = reached.begin() + 1; it != reached.end(); ++it) // Skip the starting vertex
+        result.push_back(vertices[*it]);
+    return result;
+}
+
+template <class VertexType, class Weight>
+const vector<int>& CompactGraph<VertexType, Weight>::performBFS(const int start, const bool reverse) const
+{
+    const auto outEdges = [&](const int v) { return neighbors.subspan(offsets[v], offsets[v + 1] - offsets[v]); };
+    const auto inEdges = [&](const int v)
+    {
+        return reverseSources.subspan(reverseOffsets[v], reverseOffsets[v + 1] - reverseOffsets[v]);
+    };
+
+    // Top-down steps follow out-edges (in-edges in reverse), bottom-up steps scan the other way
+    TraversalWorkspace& workspace = TraversalWorkspace::local();
+    if (reverse)
+        DirectionOptimizingBFS::run(vertexCount(), reverseSources.size(), start, inEdges, outEdges, workspace);
+    else
+        DirectionOptimizingBFS::run(vertexCount(), neighbors.size(), start, outEdges, inEdges, workspace);
+    return workspace.order;
+}
+
+template <class VertexType, class Weight>
+const vector<int>& CompactGraph<VertexType, Weight>::performParallelBFS(const int start, const unsigned int threadCount) const
+{
+    vector<int>& order = TraversalWorkspace::local().order;
+    ParallelBFS::local().run(*this, start, threadCount, order);
+    return order;
+}
+
+template <class VertexType, class Weight>
+const vector<int>& CompactGraph<VertexType, Weight>::performDFS(const int start) const
+{
+    TraversalWorkspace& workspace = TraversalWorkspace::local();
+    workspace.reset(vertexCount());
+
+    workspace.markVisited(start);
+    workspace.order.push_back(start);
+    workspace.stack.emplace_back(start, offsets[start]);
+
+    while (!workspace.stack.empty())
+    {
+        auto& [u, cursor] = workspace.stack.back();
+
+        // Advance u's cursor to its next unvisited out-neighbor
+        while (cursor < offsets[u + 1] && workspace.isVisited(neighbors[cursor]))
+            ++cursor;
+
+        if (cursor == offsets[u + 1])
+        {
+            workspace.stack.pop_back();
+            continue;
+        }
+
+        const int neighbor = neighbors[cursor++];
+        workspace.markVisited(neighbor);
+        workspace.order.push_back(neighbor);
+        workspace.stack.emplace_back(neighbor, offsets[neighbor]); // Invalidates u and cursor
+    }
+
+    return workspace.order;
+}
+
+template <class VertexType, class Weight>
+void CompactGraph<VertexType, Weight>::print() const
+{
+    for (int i = 0; i < vertexCount(); ++i)
+    {
+        cout << vertices[i] << ": ";
+
+        if (offsets[i] == offsets[i + 1])
+            continue;
+
+        forEachOutEdge(i, [&](const int neighbor, const Weight&)
+        {
+            cout << vertices[neighbor] << " ";
+        });
+
+        cout << endl;
+    }
+}
+
+#endif //COMPACTGRAPH_H
@@ -0,0 +1,451 @@
+#include "ContractionHierarchy.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+#include "Checksum.h"
+#include "EpochStamps.h"
+#include "MappedFile.h"
+#include "RadixHeap.h"
+#include "ShortestPathTree.h"
+
+namespace
+{
+    constexpr char FILE_MAGIC[8] = {'H', 'W', '5', 'C', 'H', '\0', '\0', '\0'};
+
+    /* Witness searches give up after settling this many vertices, keeping the shortcut */
+    constexpr int WITNESS_SETTLE_LIMIT = 500;
+
+    /**
+     * An edge of the graph being contracted
+     */
+    struct Arc
+    {
+        int vertex;
+        std::uint64_t weight;
+    };
+
+    /**
+     * Per-thread state of a hierarchy query, reset by epoch stamps
+     */
+    struct QueryWorkspace
+    {
+        RadixHeap queues[2];
+        std::vector<std::uint64_t> times[2]; /* Valid where stamped */
+        EpochStamps stamps[2];
+
+        void reset(const int vertexCount)
+        {
+            for (int side = 0; side < 2; ++side)
+            {
+                stamps[side].reset(vertexCount);
+                queues[side].clear();
+                if (times[side].size() < stamps[side].size())
+                    times[side].resize(stamps[side].size());
+            }
+        }
+
+        std::uint64_t timeOf(const int side, const int vertex) const
+        {
+            return stamps[side].isMarked(vertex) ? times[side][vertex] : ShortestPathTree::UNREACHABLE;
+        }
+
+        void label(const int side, const int vertex, const std::uint64_t time)
+        {
+            stamps[side].mark(vertex);
+            times[side][vertex] = time;
+            queues[side].push(time, vertex);
+        }
+    };
+
+    /**
+     * Appends <i>values</i> to <i>body</i>, after their count.
+     */
+    template <class T>
+    void writeArray(std::string& body, const std::vector<T>& values)
+    {
+        const std::uint64_t size = values.size();
+        body.append(reinterpret_cast<const char*>(&size), sizeof(size));
+        body.append(reinterpret_cast<const char*>(values.data()), size * sizeof(T));
+    }
+
+    /**
+     * Reads an array written by <i>writeArray</i> from the front of <i>body</i>, and drops it from <i>body</i>.
+     * The count is checked against the bytes left before anything is allocated.
+     * @return <i>false</i> if <i>body</i> is too short for the array.
+     */
+    template <class T>
+    bool readArray(std::string_view& body, std::vector<T>& values)
+    {
+        std::uint64_t size = 0;
+        if (body.size() < sizeof(size))
+            return false;
+        std::memcpy(&size, body.data(), sizeof(size));
+        body.remove_prefix(sizeof(size));
+        if (size > body.size() / sizeof(T) || size > std::numeric_limits<int>::max())
+            return false;
+
+        values.resize(size);
+        if (size > 0)
+            std::memcpy(values.data(), body.data(), size * sizeof(T));
+        body.remove_prefix(size * sizeof(T));
+        return true;
+    }
+
+    /**
+     * Checks that <i>ranks</i> holds every rank <i>0..ranks.size() - 1</i> once.
+     */
+    bool validRanks(const std::vector<int>& ranks)
+    {
+        std::vector<bool> seen(ranks.size(), false);
+        for (const int rank : ranks)
+        {
+            if (rank < 0 || rank >= static_cast<int>(ranks.size()) || seen[rank])
+                return false;
+            seen[rank] = true;
+        }
+        return true;
+    }
+
+    /**
+     * Checks that CSR arrays are consistent: monotone offsets covering every entry, and entries
+     * that are vertex indexes.
+     */
+    bool validCsr(const std::vector<int>& offsets, const std::vector<int>& entries, const size_t weightCount,
+                  const int vertexCount)
+    {
+        if (offsets.size() != static_cast<size_t>(vertexCount) + 1 || offsets.front() != 0 ||
+            offsets.back() != static_cast<int>(entries.size()) || weightCount != entries.size())
+            return false;
+        if (!std::is_sorted(offsets.begin(), offsets.end()))
+            return false;
+        return std::all_of(entries.begin(), entries.end(), [&](const int v) { return v >= 0 && v < vertexCount; });
+    }
+}
+
+void ContractionHierarchy::build(const CsrGraph& graph)
+{
+    const int vertexCount = graph.vertexCount();
+
+    // The remaining graph: arcs between vertices not contracted yet
+    std::vector<std::vector<Arc>> out(vertexCount);
+    std::vector<std::vector<Arc>> in(vertexCount);
+
+    // Keeps one arc per vertex pair, with the smaller weight
+    const auto addArc = [&](const int from, const int to, const std::uint64_t weight)
+    {
+        for (Arc& arc : out[from])
+        {
+            if (arc.vertex == to)
+            {
+                if (weight < arc.weight)
+                {
+                    arc.weight = weight;
+                    std::find_if(in[to].begin(), in[to].end(), [&](const Arc& a) { return a.vertex == from; })->weight = weight;
+                }
+                return;
+            }
+        }
+        out[from].push_back({to, weight});
+        in[to].push_back({from, weight});
+    };
+
+    const auto removeArc = [](std::vector<Arc>& arcs, const int vertex)
+    {
+        const auto arc = std::find_if(arcs.begin(), arcs.end(), [&](const Arc& a) { return a.vertex == vertex; });
+        *arc = arcs.back();
+        arcs.pop_back();
+    };
+
+    for (int from = 0; from < vertexCount; ++from)
+    {
+        graph.forEachOutEdge(from, [&](const int to, const std::uint64_t weight)
+        {
+            if (from != to)
+                addArc(from, to, weight);
+        });
+    }
+
+    // Witness search state: times of the vertices touched by the last search
+    std::vector<std::uint64_t> witnessTimes(vertexCount, ShortestPathTree::UNREACHABLE);
+    std::vector<int> touched;
+    RadixHeap witnessQueue;
+
+    // Shortest route from source to every remaining vertex within limit, avoiding skipped
+    const auto witnessSearch = [&](const int source, const int skipped, const std::uint64_t limit)
+    {
+        for (const int v : touched)
+            witnessTimes[v] = ShortestPathTree::UNREACHABLE;
+        touched.clear();
+        witnessQueue.clear();
+
+        witnessTimes[source] = 0;
+        touched.push_back(source);
+        witnessQueue.push(0, source);
+
+        int settled = 0;
+        while (!witnessQueue.isEmpty())
+        {
+            const auto [time, u] = witnessQueue.pop();
+            if (time != witnessTimes[u])
+                continue;
+            if (time > limit || ++settled > WITNESS_SETTLE_LIMIT)
+                break;
+
+            for (const Arc& arc : out[u])
+            {
+                if (arc.vertex == skipped)
+                    continue;
+                const std::uint64_t arrival = time + arc.weight;
+                if (arrival < witnessTimes[arc.vertex])
+                {
+                    if (witnessTimes[arc.vertex] == ShortestPathTree::UNREACHABLE)
+                        touched.push_back(arc.vertex);
+                    witnessTimes[arc.vertex] = arrival;
+                    witnessQueue.push(arrival, arc.vertex);
+                }
+            }
+        }
+    };
+
+    // Shortcuts contracting v needs; added to the remaining graph if apply is set
+    const auto contract = [&](const int v, const bool apply)
+    {
+        std::uint64_t longestOut = 0;
+        for (const Arc& arc : out[v])
+            longestOut = std::max(longestOut, arc.weight);
+
+        int shortcuts = 0;
+        for (const Arc& inArc : in[v])
+        {
+            witnessSearch(inArc.vertex, v, inArc.weight + longestOut);
+            for (const Arc& outArc : out[v])
+            {
+                if (outArc.vertex == inArc.vertex)
+                    continue;
+                const std::uint64_t via = inArc.weight + outArc.weight;
+                if (witnessTimes[outArc.vertex] > via)
+                {
+                    ++shortcuts;
+                    if (apply)
+                        addArc(inArc.vertex, outArc.vertex, via);
+                }
+            }
+        }
+        return shortcuts;
+    };
+
+    // Edge difference weighted up, plus terms spreading the contractions evenly over the graph
+    std::vector<int> contractedNeighbors(vertexCount, 0);
+    std::vector<int> levels(vertexCount, 0); /* levels[v]: depth of the hierarchy already below v */
+    const auto priority = [&](const int v)
+    {
+        const int removed = static_cast<int>(out[v].size() + in[v].size());
+        return 4 * contract(v, false) - 2 * removed + contractedNeighbors[v] + levels[v];
+    };
+
+    // Lazy updates: a popped vertex is re-scored, and contracted only if it is still the cheapest
+    using Entry = std::pair<int, int>;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<>> order;
+    for (int v = 0; v < vertexCount; ++v)
+        order.emplace(priority(v), v);
+
+    // A contracted vertex's remaining arcs all lead to or come from higher-ranked vertices
+    std::vector<std::vector<Arc>> upward(vertexCount);
+    std::vector<std::vector<Arc>> downward(vertexCount);
+    ranks.assign(vertexCount, -1);
+    int nextRank = 0;
+    while (!order.empty())
+    {
+        const int v = order.top().second;
+        order.pop();
+
+        const int current = priority(v);
+        if (!order.empty() && current > order.top().first)
+        {
+            order.emplace(current, v);
+            continue;
+        }
+
+        contract(v, true);
+        ranks[v] = nextRank++;
+        upward[v] = std::move(out[v]);
+        downward[v] = std::move(in[v]);
+        for (const Arc& arc : upward[v])
+        {
+            removeArc(in[arc.vertex], v);
+            ++contractedNeighbors[arc.vertex];
+            levels[arc.vertex] = std::max(levels[arc.vertex], levels[v] + 1);
+        }
+        for (const Arc& arc : downward[v])
+        {
+            removeArc(out[arc.vertex], v);
+            ++contractedNeighbors[arc.vertex];
+            levels[arc.vertex] = std::max(levels[arc.vertex], levels[v] + 1);
+        }
+    }
+
+    upOffsets.assign(1, 0);
+    downOffsets.assign(1, 0);
+    upTargets.clear();
+    upWeights.clear();
+    downSources.clear();
+    downWeights.clear();
+    for (int v = 0; v < vertexCount; ++v)
+    {
+        for (const Arc& arc : upward[v])
+        {
+            upTargets.push_back(arc.vertex);
+            upWeights.push_back(arc.weight);
+        }
+        for (const Arc& arc : downward[v])
+        {
+            downSources.push_back(arc.vertex);
+            downWeights.push_back(arc.weight);
+        }
+        upOffsets.push_back(static_cast<int>(upTargets.size()));
+        downOffsets.push_back(static_cast<int>(downSources.size()));
+    }
+}
+
+int ContractionHierarchy::vertexCount() const
+{
+    return static_cast<int>(ranks.size());
+}
+
+int ContractionHierarchy::edgeCount() const
+{
+    return static_cast<int>(upTargets.size() + downSources.size());
+}
+
+std::uint64_t ContractionHierarchy::travelTime(const int source, const int target) const
+{
+    thread_local QueryWorkspace workspace;
+    workspace.reset(vertexCount());
+
+    constexpr int FORWARD = 0;
+    constexpr int BACKWARD = 1;
+
+    workspace.label(FORWARD, source, 0);
+    workspace.label(BACKWARD, target, 0);
+    std::uint64_t best = source == target ? 0 : ShortestPathTree::UNREACHABLE;
+
+    // Each side stops once its minimum cannot improve on the best meeting found
+    bool done[2] = {false, false};
+    for (int side = FORWARD; !(done[FORWARD] && done[BACKWARD]); side = 1 - side)
+    {
+        if (done[side])
+            continue;
+
+        RadixHeap& queue = workspace.queues[side];
+        if (queue.isEmpty() || queue.topKey() >= best)
+        {
+            done[side] = true;
+            continue;
+        }
+
+        const auto [time, u] = queue.pop();
+        if (time != workspace.timeOf(side, u))
+            continue; // Stale entry
+
+        const std::uint64_t rest = workspace.timeOf(1 - side, u);
+        if (rest != ShortestPathTree::UNREACHABLE)
+            best = std::min(best, time + rest);
+
+        const std::vector<int>& offsets = side == FORWARD ? upOffsets : downOffsets;
+        const std::vector<int>& neighbors = side == FORWARD ? upTargets : downSources;
+        const std::vector<std::uint64_t>& weights = side == FORWARD ? upWeights : downWeights;
+
+        // Stall-on-demand: a higher-ranked vertex reaching u faster proves u's label is not on a
+        // shortest path, so u is not expanded
+        const std::vector<int>& stallOffsets = side == FORWARD ? downOffsets : upOffsets;
+        const std::vector<int>& stallNeighbors = side == FORWARD ? downSources : upTargets;
+        const std::vector<std::uint64_t>& stallWeights = side == FORWARD ? downWeights : upWeights;
+        bool stalled = false;
+        for (int e = stallOffsets[u]; e < stallOffsets[u + 1] && !stalled; ++e)
+        {
+            const std::uint64_t higher = workspace.timeOf(side, stallNeighbors[e]);
+            stalled = higher != ShortestPathTree::UNREACHABLE && higher + stallWeights[e] < time;
+        }
+        if (stalled)
+            continue;
+
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e)
+        {
+            const std::uint64_t arrival = time + weights[e];
+            if (arrival < workspace.timeOf(side, neighbors[e]))
+                workspace.label(side, neighbors[e], arrival);
+        }
+    }
+
+    return best;
+}
+
+void ContractionHierarchy::save(const std::string& fileName) const
+{
+    // The checksum comes before the arrays, so they are laid out in memory before writing
+    std::string body;
+    writeArray(body, ranks);
+    writeArray(body, upOffsets);
+    writeArray(body, upTargets);
+    writeArray(body, upWeights);
+    writeArray(body, downOffsets);
+    writeArray(body, downSources);
+    writeArray(body, downWeights);
+    const std::uint64_t bodyChecksum = checksum(body);
+
+    std::ofstream file(fileName, std::ios::binary);
+    if (!file)
+        throw std::invalid_argument("Error: Could not open file " + fileName);
+
+    file.write(FILE_MAGIC, sizeof(FILE_MAGIC));
+    file.write(reinterpret_cast<const char*>(&FILE_VERSION), sizeof(FILE_VERSION));
+    file.write(reinterpret_cast<const char*>(&bodyChecksum), sizeof(bodyChecksum));
+    file.write(body.data(), static_cast<std::streamsize>(body.size()));
+
+    if (!file)
+        throw std::invalid_argument("Error: Could not write file " + fileName);
+}
+
+ContractionHierarchy ContractionHierarchy::load(const std::string& fileName)
+{
+    const MappedFile file(fileName);
+    const std::string_view contents = file.contents();
+    const auto invalid = [&]()
+    {
+        return std::invalid_argument("Error: Not a valid contraction hierarchy file " + fileName);
+    };
+
+    std::uint32_t version = 0;
+    std::uint64_t bodyChecksum = 0;
+    constexpr std::size_t headerSize = sizeof(FILE_MAGIC) + sizeof(version) + sizeof(bodyChecksum);
+    if (contents.size() < headerSize || !std::equal(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC), contents.data()))
+        throw invalid();
+    std::memcpy(&version, contents.data() + sizeof(FILE_MAGIC), sizeof(version));
+    std::memcpy(&bodyChecksum, contents.data() + sizeof(FILE_MAGIC) + sizeof(version), sizeof(bodyChecksum));
+
+    std::string_view body = contents.substr(headerSize);
+    if (version != FILE_VERSION || checksum(body) != bodyChecksum)
+        throw invalid();
+
+    ContractionHierarchy hierarchy;
+    const bool read = readArray(body, hierarchy.ranks) &&
+                      readArray(body, hierarchy.upOffsets) && readArray(body, hierarchy.upTargets) &&
+                      readArray(body, hierarchy.upWeights) && readArray(body, hierarchy.downOffsets) &&
+                      readArray(body, hierarchy.downSources) && readArray(body, hierarchy.downWeights) &&
+                      body.empty();
+
+    const int size = hierarchy.vertexCount();
+    if (!read || !validRanks(hierarchy.ranks) ||
+        !validCsr(hierarchy.upOffsets, hierarchy.upTargets, hierarchy.upWeights.size(), size) ||
+        !validCsr(hierarchy.downOffsets, hierarchy.downSources, hierarchy.downWeights.size(), size))
+        throw invalid();
+
+    return hierarchy;
+}
@@ -0,0 +1,100 @@
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "CsrGraph.h"
+
+/**
+ * Contraction hierarchy (CH) over a graph with unsigned integer weights, for fast point-to-point
+ * travel times on a static network.
+ * Preprocessing contracts the vertices one by one, cheapest first (by edge difference plus
+ * contracted neighbors), adding a shortcut u -> w whenever contracting v removes the only shortest
+ * route u -> v -> w. A query is then a bidirectional Dijkstra that only climbs: forward along edges
+ * to higher-ranked vertices, backward along edges from higher-ranked vertices.
+ * Both edge sets are stored as CSR arrays, and can be saved to and loaded from a checksummed file
+ * so the hierarchy is not rebuilt on every start. It is a snapshot, matched to the graph by vertex index.
+ */
+class ContractionHierarchy
+{
+private:
+    static constexpr std::uint32_t FILE_VERSION = 2; /* 2 added the checksum */
+
+    std::vector<int> ranks; /* ranks[v]: position of v in the contraction order */
+    std::vector<int> upOffsets; /* Start of each vertex's upward edges in upTargets, plus a trailing end offset */
+    std::vector<int> upTargets; /* Targets of edges to higher-ranked vertices, grouped by source */
+    std::vector<std::uint64_t> upWeights; /* Parallel to upTargets */
+    std::vector<int> downOffsets; /* Start of each vertex's downward in-edges in downSources, plus a trailing end offset */
+    std::vector<int> downSources; /* Sources of edges from higher-ranked vertices, grouped by target */
+    std::vector<std::uint64_t> downWeights; /* Parallel to downSources */
+
+    /**
+     * Orders and contracts the vertices, then lays out the upward and downward CSR arrays.
+     * @param graph The graph's out-edges, with their weights.
+     */
+    void build(const CsrGraph& graph);
+
+public:
+    ContractionHierarchy() = default;
+    ~ContractionHierarchy() = default;
+    ContractionHierarchy(const ContractionHierarchy& other) = default;
+    ContractionHierarchy(ContractionHierarchy&& other) noexcept = default;
+    ContractionHierarchy& operator=(const ContractionHierarchy& other) = default;
+    ContractionHierarchy& operator=(ContractionHierarchy&& other) noexcept = default;
+
+    /**
+     * Builds the hierarchy of <i>graph</i>.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>
+     * with unsigned integer weights.
+     * @param graph The graph to preprocess.
+     */
+    template <class GraphType>
+    explicit ContractionHierarchy(const GraphType& graph);
+
+    /**
+     * @return The number of vertices.
+     */
+    int vertexCount() const;
+
+    /**
+     * @return The number of edges in the upward and downward graphs, shortcuts included.
+     */
+    int edgeCount() const;
+
+    /**
+     * Computes the shortest travel time from <i>source</i> to <i>target</i>; the same value
+     * Dijkstra's algorithm finds on the original graph. Thread-safe: the search state lives in
+     * a per-thread workspace, so repeated queries do not allocate.
+     * @param source A valid vertex index.
+     * @param target A valid vertex index.
+     * @return The travel time, <i>ShortestPathTree::UNREACHABLE</i> if there is no route.
+     */
+    std::uint64_t travelTime(int source, int target) const;
+
+    /**
+     * Writes the hierarchy to a binary file.
+     * @param fileName The file to write.
+     * @throws std::invalid_argument If the file cannot be written.
+     */
+    void save(const std::string& fileName) const;
+
+    /**
+     * Reads a hierarchy written by <i>save</i>.
+     * @param fileName The file to read.
+     * @return The hierarchy.
+     * @throws std::invalid_argument If the file cannot be read or is not a valid hierarchy: wrong
+     * header or checksum, array sizes past the end of the file, ranks that are not a permutation, or
+     * CSR arrays out of bounds.
+     */
+    static ContractionHierarchy load(const std::string& fileName);
+};
+
+template <class GraphType>
+ContractionHierarchy::ContractionHierarchy(const GraphType& graph)
+{
+    build(CsrGraph::outEdges(graph));
+}
+
+#endif //CONTRACTIONHIERARCHY_H
@@ -0,0 +1,89 @@
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * A copy of a graph's edges in compressed sparse row (CSR) form, with unsigned integer weights,
+ * for the indexes that preprocess plain arrays in their .cpp files. It is a graph type itself:
+ * it provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i> over the copied edges.
+ */
+struct CsrGraph
+{
+    std::vector<int> offsets{0}; /* Start of each vertex's edges in adjacency, plus a trailing end offset */
+    std::vector<int> adjacency; /* Edge endpoints, grouped by vertex */
+    std::vector<std::uint64_t> weights; /* Parallel to adjacency; empty if the weights were not copied */
+
+    /**
+     * Copies the out-edges of <i>graph</i>, grouped by source, with their targets as endpoints.
+     * @tparam WithWeights Whether to copy the weights too, which must then be unsigned integers.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>.
+     */
+    template <bool WithWeights = true, class GraphType>
+    static CsrGraph outEdges(const GraphType& graph);
+
+    /**
+     * Copies the in-edges of <i>graph</i>, grouped by target, with their sources as endpoints.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachInEdge(index, visit)</i> with
+     * unsigned integer weights.
+     */
+    template <class GraphType>
+    static CsrGraph inEdges(const GraphType& graph);
+
+    int vertexCount() const { return static_cast<int>(offsets.size()) - 1; }
+
+    template <class Visitor>
+    void forEachOutEdge(int index, Visitor&& visit) const;
+
+private:
+    template <bool WithWeights, class GraphType, class ForEachEdge>
+    static CsrGraph copyEdges(const GraphType& graph, const ForEachEdge& forEachEdge);
+};
+
+// Implementation
+
+template <bool WithWeights, class GraphType>
+CsrGraph CsrGraph::outEdges(const GraphType& graph)
+{
+    return copyEdges<WithWeights>(graph, [&](const int index, const auto& visit)
+    {
+        graph.forEachOutEdge(index, visit);
+    });
+}
+
+template <class GraphType>
+CsrGraph CsrGraph::inEdges(const GraphType& graph)
+{
+    return copyEdges<true>(graph, [&](const int index, const auto& visit)
+    {
+        graph.forEachInEdge(index, visit);
+    });
+}
+
+template <class Visitor>
+void CsrGraph::forEachOutEdge(const int index, Visitor&& visit) const
+{
+    for (int e = offsets[index]; e < offsets[index + 1]; ++e)
+        visit(adjacency[e], weights[e]);
+}
+
+template <bool WithWeights, class GraphType, class ForEachEdge>
+CsrGraph CsrGraph::copyEdges(const GraphType& graph, const ForEachEdge& forEachEdge)
+{
+    CsrGraph csr;
+    csr.offsets.reserve(graph.vertexCount() + 1);
+    for (int i = 0; i < graph.vertexCount(); ++i)
+    {
+        forEachEdge(i, [&](const int endpoint, [[maybe_unused]] const auto& weight)
+        {
+            csr.adjacency.push_back(endpoint);
+            if constexpr (WithWeights)
+                csr.weights.push_back(weight);
+        });
+        csr.offsets.push_back(static_cast<int>(csr.adjacency.size()));
+    }
+    return csr;
+}
+
+#endif //CSRGRAPH_H
@@ -0,0 +1,57 @@
+#ifndef DIJKSTRA_H
+#define DIJKSTRA_H
+
+#include <cstdint>
+#include <limits>
+
+#include "RadixHeap.h"
+
+/**
+ * Dijkstra's algorithm over a <i>RadixHeap</i>: the search loop shared by the shortest-path tree,
+ * the landmark tables, the repeated-Dijkstra travel time matrix and isochrone queries.
+ * Callers own the tentative times, so each keeps them in whatever storage suits it.
+ * @tparam GraphType Provides <i>forEachOutEdge(index, visit)</i> with unsigned integer weights.
+ * @param graph The graph to search.
+ * @param source A valid vertex index.
+ * @param queue Scratch queue, cleared first.
+ * @param timeOf Callable taking <i>(int vertex)</i> and returning a <i>std::uint64_t&</i> to its tentative
+ * time, which must read as larger than any route until the search sets it.
+ * @param settled Callable taking <i>(int vertex, std::uint64_t time)</i>, called once for every vertex
+ * as its shortest time becomes final, by ascending time; returns <i>false</i> to stop the search.
+ * @param improved Callable taking <i>(int vertex, int parent)</i>, called every time a shorter route to
+ * <i>vertex</i> is found through <i>parent</i>.
+ * @param limit The largest travel time to queue: longer routes are not followed.
+ */
+template <class GraphType, class TimeOf, class Settled, class Improved>
+void dijkstra(const GraphType& graph, const int source, RadixHeap& queue, TimeOf&& timeOf, Settled&& settled,
+              Improved&& improved, const std::uint64_t limit = std::numeric_limits<std::uint64_t>::max())
+{
+    queue.clear();
+    timeOf(source) = 0;
+    queue.push(0, source);
+
+    while (!queue.isEmpty())
+    {
+        const auto [time, u] = queue.pop();
+        if (time != timeOf(u))
+            continue; // Stale entry, u was reached faster since
+        if (!settled(u, time))
+            return;
+
+        graph.forEachOutEdge(u, [&](const int neighbor, const auto& weight)
+        {
+            const std::uint64_t arrival = time + weight;
+            if (arrival > limit)
+                return;
+            std::uint64_t& neighborTime = timeOf(neighbor);
+            if (arrival < neighborTime)
+            {
+                neighborTime = arrival;
+                improved(neighbor, u);
+                queue.push(arrival, neighbor);
+            }
+        });
+    }
+}
+
+#endif //DIJKSTRA_H
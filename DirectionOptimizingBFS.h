@@ -0,0 +1,126 @@
+#ifndef DIRECTIONOPTIMIZINGBFS_H
+#define DIRECTIONOPTIMIZINGBFS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "TraversalWorkspace.h"
+
+/**
+ * Breadth-first search that expands each level the cheaper of two ways: top-down, following the
+ * level's edges, or bottom-up, having every unvisited vertex scan its edges back for a parent in
+ * the level. Bottom-up scans fewer edges once a level covers much of the graph.
+ * Both give the vertices in the same order as a queue-based BFS: a bottom-up step takes the
+ * earliest-reached parent of each vertex it finds, and emits them by parent, then by index.
+ */
+class DirectionOptimizingBFS
+{
+public:
+    /**
+     * Searches from <i>start</i> in <i>workspace</i>.
+     * @tparam Down Callable taking <i>(int vertex)</i> and returning the vertices a top-down step
+     * reaches from it, ascending, as a range with <i>size()</i>.
+     * @tparam Up Callable taking <i>(int vertex)</i> and returning the vertices a top-down step reaches
+     * it from, the same way: the other direction of the same edges.
+     * @param vertexCount Number of vertices.
+     * @param edgeCount Number of edges.
+     * @param start A valid vertex index.
+     * @param down The edges to follow.
+     * @param up The same edges, reversed.
+     * @param workspace Reset first; its <i>order</i> receives the reached vertices, <i>start</i> first.
+     */
+    template <class Down, class Up>
+    static void run(int vertexCount, std::size_t edgeCount, int start, const Down& down, const Up& up,
+                    TraversalWorkspace& workspace);
+};
+
+template <class Down, class Up>
+void DirectionOptimizingBFS::run(const int vertexCount, const std::size_t edgeCount, const int start,
+                                 const Down& down, const Up& up, TraversalWorkspace& workspace)
+{
+    workspace.reset(vertexCount);
+
+    std::vector<int>& order = workspace.order; // Doubles as the queue: vertices in visit order, level by level
+    std::vector<int>& positions = workspace.positions;
+    std::vector<int>& pending = workspace.pending;
+    std::vector<std::pair<int, int>>& found = workspace.found;
+
+    std::size_t frontierEdges = 0; // Edges out of the level being built: the cost of expanding it top-down
+    std::size_t unexploredEdges = edgeCount; // Edges into unvisited vertices: the cost of a bottom-up step
+    const auto visit = [&](const int v)
+    {
+        workspace.markVisited(v);
+        positions[v] = static_cast<int>(order.size());
+        order.push_back(v);
+        frontierEdges += down(v).size();
+        unexploredEdges -= up(v).size();
+    };
+    visit(start);
+
+    bool pendingListed = false; // pending holds the unvisited vertices, ascending
+    for (std::size_t levelStart = 0; levelStart < order.size();)
+    {
+        const std::size_t levelEnd = order.size();
+        const std::size_t levelEdges = frontierEdges;
+        frontierEdges = 0;
+
+        if (levelEdges <= unexploredEdges + (static_cast<std::size_t>(vertexCount) - levelEnd))
+        {
+            // Top-down: expand the level's edges
+            pendingListed = false;
+            for (std::size_t i = levelStart; i < levelEnd; ++i)
+            {
+                for (const int next : down(order[i]))
+                {
+                    if (!workspace.isVisited(next))
+                        visit(next);
+                }
+            }
+        }
+        else
+        {
+            // Bottom-up: every unvisited vertex looks for a parent in the level. An unvisited
+            // vertex's visited neighbors all belong to the level, and the earliest of them is the
+            // parent a top-down step would have reached it from.
+            if (!pendingListed)
+            {
+                pending.clear();
+                for (int v = 0; v < vertexCount; ++v)
+                {
+                    if (!workspace.isVisited(v))
+                        pending.push_back(v);
+                }
+                pendingListed = true;
+            }
+
+            found.clear();
+            std::size_t kept = 0;
+            for (const int v : pending)
+            {
+                int parent = static_cast<int>(levelEnd);
+                for (const int previous : up(v))
+                {
+                    if (workspace.isVisited(previous))
+                        parent = std::min(parent, positions[previous]);
+                }
+
+                if (parent < static_cast<int>(levelEnd))
+                    found.emplace_back(parent, v);
+                else
+                    pending[kept++] = v;
+            }
+            pending.resize(kept);
+
+            // The order a top-down step gives: by parent, then by index
+            std::sort(found.begin(), found.end());
+            for (const auto& [parent, v] : found)
+                visit(v);
+        }
+
+        levelStart = levelEnd;
+    }
+}
+
+#endif //DIRECTIONOPTIMIZINGBFS_H
@@ -0,0 +1,73 @@
+#include "DisjointSets.h"
+
+#include <numeric>
+#include <utility>
+
+void DisjointSets::reset(const int size)
+{
+    parents.resize(size);
+    std::iota(parents.begin(), parents.end(), 0);
+    ranks.assign(size, 0);
+    setCount = size;
+}
+
+int DisjointSets::add()
+{
+    const int element = static_cast<int>(parents.size());
+    parents.push_back(element);
+    ranks.push_back(0);
+    ++setCount;
+    return element;
+}
+
+int DisjointSets::find(const int element)
+{
+    int root = element;
+    while (parents[root] != root)
+        root = parents[root];
+
+    for (int e = element; parents[e] != root;)
+        e = std::exchange(parents[e], root);
+
+    return root;
+}
+
+int DisjointSets::representative(int element) const
+{
+    while (parents[element] != element)
+        element = parents[element];
+    return element;
+}
+
+bool DisjointSets::unite(const int a, const int b)
+{
+    int rootA = find(a);
+    int rootB = find(b);
+    if (rootA == rootB)
+        return false;
+
+    if (ranks[rootA] < ranks[rootB])
+        std::swap(rootA, rootB);
+    parents[rootB] = rootA;
+    if (ranks[rootA] == ranks[rootB])
+        ++ranks[rootA];
+
+    --setCount;
+    return true;
+}
+
+void DisjointSets::flatten()
+{
+    for (int element = 0; element < size(); ++element)
+        find(element);
+}
+
+int DisjointSets::size() const
+{
+    return static_cast<int>(parents.size());
+}
+
+int DisjointSets::countSets() const
+{
+    return setCount;
+}
@@ -0,0 +1,78 @@
+#ifndef DISJOINTSETS_H
+#define DISJOINTSETS_H
+
+#include <vector>
+
+/**
+ * Disjoint sets of elements <i>0..size() - 1</i> (union-find), with union by rank and path
+ * compression, so a sequence of operations costs O(alpha(n)) amortized each.
+ * Used for the weakly connected components of a graph, which only grow as edges are added.
+ */
+class DisjointSets
+{
+private:
+    std::vector<int> parents; /* parents[e]: e's parent in its set's tree, e itself for a root */
+    std::vector<unsigned char> ranks; /* ranks[r]: upper bound on the height of root r's tree */
+    int setCount{0};
+
+public:
+    DisjointSets() = default;
+    ~DisjointSets() = default;
+    DisjointSets(const DisjointSets& other) = default;
+    DisjointSets(DisjointSets&& other) noexcept = default;
+    DisjointSets& operator=(const DisjointSets& other) = default;
+    DisjointSets& operator=(DisjointSets&& other) noexcept = default;
+
+    /**
+     * Replaces the sets with <i>size</i> singletons.
+     * @param size Number of elements.
+     */
+    void reset(int size);
+
+    /**
+     * Adds a new element in a set of its own.
+     * @return The new element, <i>size() - 1</i>.
+     */
+    int add();
+
+    /**
+     * Finds the representative of <i>element</i>'s set, pointing the path to it straight at the root.
+     * @param element A valid element.
+     * @return The representative, the same for every element of the set until the next <i>unite</i>.
+     */
+    int find(int element);
+
+    /**
+     * Finds the representative of <i>element</i>'s set without changing the trees, for read-only
+     * lookups that may run concurrently. O(log n), as union by rank bounds the height of every tree;
+     * O(1) after <i>flatten</i>, until the next <i>unite</i> that merges two sets.
+     * @param element A valid element.
+     * @return The same representative as <i>find</i>.
+     */
+    int representative(int element) const;
+
+    /**
+     * Merges the sets of <i>a</i> and <i>b</i>, hanging the shallower tree under the deeper one.
+     * @param a A valid element.
+     * @param b A valid element.
+     * @return <i>true</i> if they were in different sets.
+     */
+    bool unite(int a, int b);
+
+    /**
+     * Points every element straight at its set's root, so that <i>representative</i> reads it in O(1).
+     */
+    void flatten();
+
+    /**
+     * @return The number of elements.
+     */
+    int size() const;
+
+    /**
+     * @return The number of sets.
+     */
+    int countSets() const;
+};
+
+#endif //DISJOINTSETS_H
@@ -0,0 +1,23 @@
+#include "EpochStamps.h"
+
+#include <algorithm>
+#include <limits>
+
+void EpochStamps::reset(const int vertexCount)
+{
+    if (epoch == std::numeric_limits<unsigned int>::max())
+    {
+        // Stamps from 2^32 searches ago would look current again
+        std::fill(stamps.begin(), stamps.end(), 0);
+        epoch = 0;
+    }
+    ++epoch;
+
+    if (stamps.size() < static_cast<std::size_t>(vertexCount))
+        stamps.resize(vertexCount, 0);
+}
+
+std::size_t EpochStamps::size() const
+{
+    return stamps.size();
+}
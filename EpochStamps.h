@@ -0,0 +1,67 @@
+#ifndef EPOCHSTAMPS_H
+#define EPOCHSTAMPS_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * Per-vertex marks for a search that are all cleared in O(1): a vertex is marked when its stamp
+ * equals the current epoch, and starting a new search bumps the epoch instead of clearing the array.
+ * Shared by the traversal and search workspaces, which keep their other per-vertex buffers valid
+ * only where a vertex is marked.
+ */
+class EpochStamps
+{
+private:
+    std::vector<unsigned int> stamps; /* stamps[v] == epoch iff v is marked */
+    unsigned int epoch{0};
+
+public:
+    EpochStamps() = default;
+    ~EpochStamps() = default;
+    EpochStamps(const EpochStamps& other) = default;
+    EpochStamps(EpochStamps&& other) noexcept = default;
+    EpochStamps& operator=(const EpochStamps& other) = default;
+    EpochStamps& operator=(EpochStamps&& other) noexcept = default;
+
+    /**
+     * Unmarks every vertex, and grows the marks to at least <i>vertexCount</i> vertices.
+     * @param vertexCount Number of vertices of the graph about to be searched.
+     */
+    void reset(int vertexCount);
+
+    /**
+     * @return The number of vertices the marks cover, at least every count given to <i>reset</i>.
+     */
+    std::size_t size() const;
+
+    /**
+     * Marks <i>vertex</i>.
+     * @param vertex A vertex index below <i>size()</i>.
+     * @return <i>true</i> if it was not marked yet, <i>false</i> otherwise.
+     */
+    bool mark(int vertex);
+
+    /**
+     * @param vertex A vertex index below <i>size()</i>.
+     * @return <i>true</i> if <i>vertex</i> is marked.
+     */
+    bool isMarked(int vertex) const;
+};
+
+// Called once per examined edge, so defined here where every search can inline them
+
+inline bool EpochStamps::mark(const int vertex)
+{
+    if (stamps[vertex] == epoch)
+        return false;
+    stamps[vertex] = epoch;
+    return true;
+}
+
+inline bool EpochStamps::isMarked(const int vertex) const
+{
+    return stamps[vertex] == epoch;
+}
+
+#endif //EPOCHSTAMPS_H
@@ -1,11 +1,36 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <concepts>
 #include <iomanip>
 #include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
-#include "VectorQueue.h"
+#include "AStarSearch.h"
+#include "BidirectionalSearch.h"
+#include "CompactGraph.h"
+#include "ContractionHierarchy.h"
+#include "DirectionOptimizingBFS.h"
+#include "DisjointSets.h"
+#include "HopLimitedBFS.h"
+#include "IsochroneSearch.h"
+#include "LandmarkIndex.h"
+#include "MultiSourceBFS.h"
+#include "ParallelBFS.h"
+#include "ReachabilityIndex.h"
+#include "ShortestPathTree.h"
+#include "StaleFlag.h"
+#include "TransitiveClosure.h"
+#include "TravelTimeMatrix.h"
+#include "TraversalWorkspace.h"
 #include "EdgeAlreadyExistsException.h"
 #include "EdgeNotFoundException.h"
 #include "VertexNotFoundException.h"
@@ -28,12 +53,29 @@ struct VertexIndex
     {}
 };
 
+/**
+ * A route through the graph
+ * @tparam VertexType The vertex type.
+ */
+template <typename VertexType>
+struct Route
+{
+    vector<VertexType> stops; /* The stops, origin first; empty if there is no route */
+    uint64_t time; /* Total travel time, ShortestPathTree::UNREACHABLE if there is no route */
+};
+
 
 /**
  * A directed graph, implemented using an adjacency matrix.
+ * The matrix is a single row-major buffer: row <i>i</i> starts at <i>i * stride</i>.
+ * The stride doubles when a vertex is added past it, so growth is amortized,
+ * and cells past the last vertex are always <i>Weight()</i>.
+ * Sorted out-edge and in-edge index lists are kept next to the matrix, so the edges
+ * of a vertex are iterated in O(degree) in either direction.
  * @tparam VertexType The vertex type. Must support:
  * - `<<` for output.
  * - `=` for deep copying.
+ * - `==` and a `std::hash` specialization, used to index the vertices.
  * @tparam Weight The weight type. Must support:
  * - A default constructor (`Weight()`) used as an "empty" indicator.
  * - `==` for comparisons
@@ -44,7 +86,68 @@ class Graph
 {
 private:
     vector<VertexIndex<VertexType>> vertices; /* Stores the list of vertices, and indexes */
-    vector<vector<Weight>> matrix; /* The adjacency matrix storing edge weights. */
+    unordered_map<VertexType, int> indexes; /* Maps each vertex to its index in the matrix */
+    vector<Weight> matrix; /* The adjacency matrix storing edge weights, one row per vertex */
+    size_t stride = 0; /* Distance between consecutive rows of matrix, at least vertices.size() */
+    vector<vector<int>> targets; /* targets[i]: indexes with an edge from i, ascending */
+    vector<vector<int>> sources; /* sources[i]: indexes with an edge to i, ascending */
+    size_t edgeCount = 0; /* Number of edges, the total size of targets */
+    optional<ReachabilityIndex> reachability; /* SCC reachability index, dropped by any change to the vertices or edges */
+    optional<TransitiveClosure> closure; /* Bitset transitive closure, dropped like reachability */
+    optional<ContractionHierarchy> hierarchy; /* Contraction hierarchy for travel times, dropped by any change to the edges or weights */
+    optional<LandmarkIndex> landmarks; /* ALT landmark tables for travel times, dropped like hierarchy */
+    mutable DisjointSets components; /* Weakly connected components, merged as edges are added */
+    mutable StaleFlag componentsStale; /* Components were merged or split since components was flattened */
+    mutable bool componentsSplit = false; /* An edge or vertex was removed since components was built */
+
+    /**
+     * Drops the reachability index, the transitive closure, the contraction hierarchy and the
+     * landmark tables, after a change to the vertices or edges.
+     */
+    void dropIndexes();
+
+    /**
+     * Drops the contraction hierarchy and the landmark tables, after a change to a weight: shortcuts,
+     * rank order and landmark distances depend on the weights, not only on which edges exist.
+     */
+    void dropTravelTimeIndexes();
+
+    /**
+     * Brings <i>components</i> up to date if it is stale: rebuilds it from the edge lists if a removal
+     * may have split a component, then points every vertex straight at its representative, so that
+     * lookups read it in O(1). A cache refresh, so it is allowed from const lookups: concurrent
+     * callers wait while one of them rebuilds.
+     */
+    void refreshComponents() const;
+
+    /**
+     * Retrieves the matrix cell of the edge from index <i>from</i> to index <i>to</i>.
+     * @param from The source index.
+     * @param to The destination index.
+     * @return The cell, <i>Weight()</i> if there is no edge.
+     */
+    Weight& weightAt(int from, int to);
+
+    const Weight& weightAt(int from, int to) const;
+
+    /**
+     * Sets the matrix cell from index <i>from</i> to index <i>to</i>, and adds or removes
+     * the edge in <i>targets</i> and <i>sources</i> when it appears or disappears.
+     * @param from The source index.
+     * @param to The destination index.
+     * @param weight The new weight, <i>Weight()</i> for no edge.
+     */
+    void setWeight(int from, int to, const Weight& weight);
+
+    /**
+     * Moves the matrix to a new stride, keeping every row and filling new cells with <i>Weight()</i>.
+     * The new buffer reserves <i>newStride * newStride</i> cells, so the rows added up to the next
+     * doubling never reallocate. The reservation is only address space until rows are appended, but
+     * under strict overcommit it is charged in full: about 1 GiB at 10k stations of 4-byte weights,
+     * 4 GiB at 20k.
+     * @param newStride The new stride, at least vertices.size().
+     */
+    void restride(size_t newStride);
 
     /**
      * Validates whether both <i>from</i> and <i>to</i> exist in the graph.
@@ -79,22 +182,36 @@ private:
     bool vertexExists(const VertexType& vertex) const;
 
     /**
-     * Updates the indexes after insertion and removal of vertices
+     * Updates the indexes after removal of vertices, and rebuilds <i>indexes</i>
      */
     void updateIndexes();
 
     /**
-     * Retrieves the index of <i>vertex</i> in <i>vertices</i>
-     * @param vertex Vertex to get the index to
-     * @return the index of <i>vertex</i> in <i>vertices</i>
+     * Breadth-first search from <i>start</i>, in the calling thread's <i>TraversalWorkspace</i>.
+     * Direction-optimizing, by <i>DirectionOptimizingBFS</i> over the sorted edge lists.
+     * @param start A valid vertex index.
+     * @param reverse Follow in-edges instead of out-edges.
+     * @return The workspace's <i>order</i>: reached vertices, <i>start</i> first. Valid until the next traversal.
      */
-    int getIndexForVertex(const VertexType& vertex) const;
-
-    vector<VertexType> performBFS(const VertexType& vertex) const;
+    const vector<int>& performBFS(int start, bool reverse = false) const;
 
-    vector<VertexType> performDFS(const VertexType& vertex) const;
+    /**
+     * Breadth-first search from <i>start</i> on <i>threadCount</i> threads, by <i>ParallelBFS</i>.
+     * @param start A valid vertex index.
+     * @param threadCount Number of threads to use, at least 1.
+     * @return The calling thread's <i>TraversalWorkspace</i> <i>order</i>: reached vertices, level by level,
+     * <i>start</i> first. Valid until the next traversal.
+     */
+    const vector<int>& performParallelBFS(int start, unsigned int threadCount) const;
 
-    void dfs_visit(const VertexType &u, vector<bool> &visited, vector<VertexType> &result) const;
+    /**
+     * Depth-first search from <i>start</i>, in the calling thread's <i>TraversalWorkspace</i>.
+     * Iterative: each stack frame keeps a cursor to its vertex's next out-edge, so every edge
+     * is examined once and call-stack depth stays constant however long the path.
+     * @param start A valid vertex index.
+     * @return The workspace's <i>order</i>: reached vertices, <i>start</i> first. Valid until the next traversal.
+     */
+    const vector<int>& performDFS(int start) const;
 
 public:
     Graph() = default;
@@ -103,6 +220,17 @@ public:
     Graph& operator=(const Graph& other) = default;
     Graph& operator=(Graph&& other) noexcept = default;
 
+    /**
+     * Builds a graph from CSR arrays in one pass, as <i>GraphBuilder</i> produces them:
+     * the same graph as adding the vertices in order, then the edges.
+     * @param vertices The vertices, by index, without duplicates.
+     * @param offsets <i>vertices.size() + 1</i> offsets into <i>neighbors</i>.
+     * @param neighbors Out-edge targets, grouped by source and strictly ascending within each group.
+     * @param weights Out-edge weights, parallel to <i>neighbors</i>, none equal to <i>Weight()</i>.
+     */
+    Graph(const vector<VertexType>& vertices, const vector<int>& offsets, const vector<int>& neighbors,
+          const vector<Weight>& weights);
+
     /**
      * Adds a vertex to the graph.
      * @param vertex The vertex to add.
@@ -165,9 +293,47 @@ public:
      * Retrieves all vertices that can be reached from <i>vertex</i> using any number of edges.
      * @param vertex The starting vertex for the search.
      * @param useBFS
+     * @param threadCount Number of threads for a breadth-first search. Above 1, the search is
+     * level-synchronous over <i>ParallelBFS</i>: the same vertices, level by level, but in no fixed
+     * order within a level.
      * @return A vector of all reachable vertices.
      */
-    vector<VertexType> getConnections(VertexType vertex, bool useBFS = true) const;
+    vector<VertexType> getConnections(VertexType vertex, bool useBFS = true, unsigned int threadCount = 1) const;
+
+    /**
+     * Retrieves the vertices reachable from <i>vertex</i> using at most <i>maxHops</i> edges,
+     * by a BFS in the calling thread's <i>HopLimitedBFS</i> that stops after <i>maxHops</i> levels.
+     * @param vertex The starting vertex.
+     * @param maxHops The largest number of edges (transfers) to use.
+     * @return Each reachable vertex other than <i>vertex</i> with its hop count, by ascending hop count.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    vector<pair<VertexType, int>> getConnectionsWithinHops(VertexType vertex, int maxHops) const;
+
+    /**
+     * Runs <i>getConnections</i> for many sources at once: batches of <i>MultiSourceBFS::BATCH_SIZE</i>
+     * sources share one multi-source BFS, and batches are spread over <i>threadCount</i> threads.
+     * @param sourceVertices The starting vertices.
+     * @param threadCount Number of threads to use, at least 1.
+     * @return For each starting vertex, the same vertices as <i>getConnections</i>, by hop distance.
+     * @throws VertexNotFoundException If a starting vertex does not exist.
+     */
+    vector<vector<VertexType>> getConnectionsBatch(const vector<VertexType>& sourceVertices,
+                                                   unsigned int threadCount = 1) const;
+
+    /**
+     * Streaming form of <i>getConnectionsBatch</i>, for reports too large to hold at once:
+     * calls <i>visit(position, reachedIndexes)</i> as soon as the search from
+     * <i>sourceVertices[position]</i> is done. Calls come from the worker threads concurrently.
+     * @param sourceVertices The starting vertices.
+     * @param threadCount Number of threads to use, at least 1.
+     * @param visit Thread-safe callable taking <i>(size_t, const vector<int>&)</i>; the indexes
+     * are those of <i>getConnections</i>, by hop distance, and are only valid during the call.
+     * @throws VertexNotFoundException If a starting vertex does not exist.
+     */
+    template <class Visitor>
+    void forEachConnectionsBatch(const vector<VertexType>& sourceVertices, unsigned int threadCount,
+                                 Visitor&& visit) const;
 
     /**
      * Retrieves all vertices that have a direct edge to <i>vertex</i>.
@@ -176,6 +342,219 @@ public:
      */
     vector<VertexType> getDirectSources(VertexType vertex) const;
 
+    /**
+     * Retrieves all vertices that can reach <i>vertex</i> using any number of edges,
+     * by a breadth-first search over in-edges.
+     * @param vertex The target vertex for the search.
+     * @return A vector of all vertices that reach <i>vertex</i>.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    vector<VertexType> getReverseConnections(VertexType vertex) const;
+
+    /**
+     * Retrieves the weakly connected component of <i>vertex</i>: the stations linked to it by edges
+     * in either direction, the same network. Components are merged in O(alpha(n)) as edges are
+     * added. The first lookup after a merge flattens them in O(V), after rebuilding them in
+     * O(V + E) if <i>removeEdge</i> or <i>removeVertex</i> was called; it does so under a lock, so
+     * lookups may run concurrently. Every other lookup is an O(1) read.
+     * @param vertex The vertex.
+     * @return The index of the component's representative vertex, equal for two vertices exactly
+     * when they are in the same component. Valid until the next change to the vertices or edges.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    int getComponentId(VertexType vertex) const;
+
+    /**
+     * Checks whether <i>a</i> and <i>b</i> are in the same weakly connected component, as by
+     * <i>getComponentId</i>. <i>false</i> means neither reaches the other.
+     * @param a A vertex.
+     * @param b A vertex.
+     * @return <i>true</i> if a chain of edges, followed in either direction, links them.
+     * @throws VertexNotFoundException If one or both of the vertices do not exist.
+     */
+    bool inSameNetwork(VertexType a, VertexType b) const;
+
+    /**
+     * @return The number of weakly connected components, isolated vertices included.
+     */
+    int componentCount() const;
+
+    /**
+     * Builds the strongly connected component reachability index used by <i>getReachable</i>.
+     * Any later change to the vertices or edges drops the index.
+     */
+    void buildReachabilityIndex();
+
+    /**
+     * @return <i>true</i> if the reachability index is built and up to date.
+     */
+    bool hasReachabilityIndex() const;
+
+    /**
+     * Builds the packed bitset transitive closure used by <i>getReachable</i> and <i>isReachable</i>.
+     * It costs <i>componentCount * V / 8</i> bytes, so it is optional; the returned closure
+     * reports its memory use and build time.
+     * Any later change to the vertices or edges drops the closure.
+     * @return The built closure.
+     */
+    const TransitiveClosure& buildTransitiveClosure();
+
+    /**
+     * Checks whether <i>to</i> is among <i>getConnections(from)</i>: a bit test if the transitive
+     * closure is built, a lookup in the reachability index if that is built, a BFS otherwise.
+     * @param from The source vertex.
+     * @param to The destination vertex.
+     * @return <i>true</i> if <i>from != to</i> and a path leads from <i>from</i> to <i>to</i>.
+     * @throws VertexNotFoundException If one or both of the vertices do not exist.
+     */
+    bool isReachable(VertexType from, VertexType to) const;
+
+    /**
+     * Retrieves the same vertices as <i>getConnections(vertex)</i>, without traversing the graph
+     * if an index is built: by ascending index from the transitive closure, or grouped by strongly
+     * connected component from the reachability index. By BFS otherwise.
+     * @param vertex The starting vertex.
+     * @return A vector of all reachable vertices.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    vector<VertexType> getReachable(VertexType vertex) const;
+
+    /**
+     * Computes the shortest travel time from <i>from</i> to every vertex, summing edge weights
+     * (the hop times loaded by <i>Parser</i>). Only for unsigned integer weights.
+     * @param from The source vertex.
+     * @return The travel times and shortest-path tree, by vertex index.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    ShortestPathTree travelTimes(VertexType from) const requires unsigned_integral<Weight>;
+
+    /**
+     * Finds every vertex within <i>maxMinutes</i> of <i>vertex</i> (an isochrone), summing the hop
+     * times loaded by <i>Parser</i>. A Dijkstra search cut off at the budget, in the calling thread's
+     * <i>IsochroneSearch</i>: unlike <i>getConnections</i>, it never looks past the budget.
+     * Only for unsigned integer weights.
+     * @param vertex The starting vertex.
+     * @param maxMinutes The travel-time budget.
+     * @return Each vertex other than <i>vertex</i> reachable within the budget with its shortest
+     * travel time, by ascending time.
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    vector<pair<VertexType, uint64_t>> reachableWithin(VertexType vertex, uint64_t maxMinutes) const
+        requires unsigned_integral<Weight>;
+
+    /**
+     * Computes the origin x destination table of shortest travel times between all vertices,
+     * by repeated Dijkstra on a sparse graph and blocked Floyd-Warshall on a dense one.
+     * Only for unsigned integer weights.
+     * @param threadCount Number of threads to use, at least 1.
+     * @return The travel times, by vertex index.
+     */
+    TravelTimeMatrix allPairsTravelTimes(unsigned int threadCount = 1) const requires unsigned_integral<Weight>;
+
+    /**
+     * Computes the shortest travel time from <i>from</i> to <i>to</i>: from the contraction hierarchy
+     * if one is in use, else by A* in the calling thread's <i>AStarSearch</i> if landmarks are built
+     * (its <i>getSettledCount()</i> then reports the query's search space), else by bidirectional
+     * Dijkstra in the calling thread's <i>BidirectionalSearch</i>. Repeated queries do not allocate.
+     * Only for unsigned integer weights.
+     * @param from The source vertex.
+     * @param to The destination vertex.
+     * @return The travel time, <i>ShortestPathTree::UNREACHABLE</i> if <i>to</i> is unreachable.
+     * @throws VertexNotFoundException If one or both of the vertices do not exist.
+     */
+    uint64_t travelTime(VertexType from, VertexType to) const requires unsigned_integral<Weight>;
+
+    /**
+     * Builds the contraction hierarchy <i>travelTime</i> answers from while it is up to date.
+     * Preprocessing is slow next to a single query, so it is optional; save the returned hierarchy
+     * and hand it to <i>useContractionHierarchy</i> on later runs over the same input.
+     * Any later change to the vertices, edges or weights drops the hierarchy. Only for unsigned integer weights.
+     * @return The built hierarchy.
+     */
+    const ContractionHierarchy& buildContractionHierarchy() requires unsigned_integral<Weight>;
+
+    /**
+     * Answers <i>travelTime</i> from a previously built hierarchy, such as one loaded from a file.
+     * The hierarchy must have been built from a graph with the same vertex indexes and edges.
+     * Only for unsigned integer weights.
+     * @param loaded The hierarchy.
+     * @throws std::invalid_argument If the hierarchy's vertex count differs from the graph's.
+     */
+    void useContractionHierarchy(ContractionHierarchy loaded) requires unsigned_integral<Weight>;
+
+    /**
+     * Chooses landmarks and builds the distance tables <i>travelTime</i> uses to guide an A* search
+     * while they are up to date. Cheap next to a contraction hierarchy: two Dijkstra runs per
+     * landmark, and <i>8 * count</i> bytes per vertex. More landmarks give tighter bounds, so
+     * fewer settled vertices per query. Any later change to the vertices, edges or weights drops the tables.
+     * Only for unsigned integer weights.
+     * @param count Number of landmarks, capped at the number of vertices.
+     * @return The built tables.
+     */
+    const LandmarkIndex& buildLandmarks(int count = 16) requires unsigned_integral<Weight>;
+
+    /**
+     * Finds a fastest route from <i>from</i> to <i>to</i> by bidirectional Dijkstra.
+     * Only for unsigned integer weights.
+     * @param from The source vertex.
+     * @param to The destination vertex.
+     * @return The route's stops and travel time; no stops if <i>to</i> is unreachable.
+     * @throws VertexNotFoundException If one or both of the vertices do not exist.
+     */
+    Route<VertexType> shortestPath(VertexType from, VertexType to) const requires unsigned_integral<Weight>;
+
+    /**
+     * Builds an immutable compressed-sparse-row copy of the graph, for read-only queries.
+     * Vertex indexes and neighbor order are preserved.
+     * @return A <i>CompactGraph</i> with the same vertices and edges.
+     */
+    CompactGraph<VertexType, Weight> freeze() const;
+
+    /**
+     * Saves the graph as a binary snapshot, which <i>CompactGraph::loadSnapshot</i> loads without parsing.
+     * @param fileName The file to write.
+     * @throws std::invalid_argument If the file cannot be written.
+     */
+    void saveSnapshot(const string& fileName) const requires same_as<VertexType, string> && is_trivially_copyable_v<Weight>;
+
+    /**
+     * @return The number of vertices; valid indexes are <i>0..vertexCount() - 1</i>.
+     */
+    int vertexCount() const;
+
+    /**
+     * Retrieves the index of <i>vertex</i> in <i>vertices</i>
+     * @param vertex Vertex to get the index to
+     * @return the index of <i>vertex</i> in <i>vertices</i>
+     * @throws VertexNotFoundException If the vertex does not exist.
+     */
+    int getIndexForVertex(const VertexType& vertex) const;
+
+    /**
+     * Retrieves the vertex stored at <i>index</i>.
+     * @param index A valid vertex index.
+     * @return The vertex at <i>index</i>.
+     */
+    const VertexType& getVertex(int index) const;
+
+    /**
+     * Calls <i>visit(neighborIndex, weight)</i> for every out-edge of the vertex at <i>index</i>,
+     * by ascending neighbor index. Does not allocate.
+     * @param index A valid vertex index.
+     * @param visit Callable taking <i>(int, const Weight&)</i>.
+     */
+    template <class Visitor>
+    void forEachOutEdge(int index, Visitor&& visit) const;
+
+    /**
+     * Calls <i>visit(sourceIndex, weight)</i> for every in-edge of the vertex at <i>index</i>,
+     * by ascending source index. Does not allocate.
+     * @param index A valid vertex index.
+     * @param visit Callable taking <i>(int, const Weight&)</i>.
+     */
+    template <class Visitor>
+    void forEachInEdge(int index, Visitor&& visit) const;
+
     /**
      * Prints the adjacency matrix representation of the graph.
      */
@@ -211,50 +590,175 @@ template <class VertexType, class Weight>
 bool Graph<VertexType, Weight>::edgeExists(const VertexType& from, const VertexType& to) const
 {
     validateVertices(from, to);
-    return matrix[getIndexForVertex(from)][getIndexForVertex(to)] != Weight();
+    return weightAt(getIndexForVertex(from), getIndexForVertex(to)) != Weight();
 }
 
 template <class VertexType, class Weight>
-bool Graph<VertexType, Weight>::vertexExists(const VertexType& vertex) const
+Weight& Graph<VertexType, Weight>::weightAt(const int from, const int to)
+{
+    return matrix[from * stride + to];
+}
+
+template <class VertexType, class Weight>
+const Weight& Graph<VertexType, Weight>::weightAt(const int from, const int to) const
 {
-    for (auto currVertex : vertices)
+    return matrix[from * stride + to];
+}
+
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::setWeight(const int from, const int to, const Weight& weight)
+{
+    Weight& cell = weightAt(from, to);
+    const bool hadEdge = cell != Weight();
+    const bool hasEdge = weight != Weight();
+    const bool changed = cell != weight;
+    cell = weight;
+
+    if (hasEdge != hadEdge)
+        dropIndexes();
+    else if (changed)
+        dropTravelTimeIndexes();
+
+    if (hasEdge and not hadEdge)
+    {
+        ++edgeCount;
+        if (components.unite(from, to))
+            componentsStale.set();
+        targets[from].insert(lower_bound(targets[from].begin(), targets[from].end(), to), to);
+        sources[to].insert(lower_bound(sources[to].begin(), sources[to].end(), from), from);
+    }
+    else if (hadEdge and not hasEdge)
     {
-        if (currVertex.vertex == vertex)
-            return true;
+        --edgeCount;
+        componentsSplit = true;
+        componentsStale.set();
+        targets[from].erase(lower_bound(targets[from].begin(), targets[from].end(), to));
+        sources[to].erase(lower_bound(sources[to].begin(), sources[to].end(), from));
     }
-    return false;
+}
+
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::dropIndexes()
+{
+    reachability.reset();
+    closure.reset();
+    dropTravelTimeIndexes();
+}
+
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::dropTravelTimeIndexes()
+{
+    hierarchy.reset();
+    landmarks.reset();
+}
+
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::refreshComponents() const
+{
+    componentsStale.refresh([&]()
+    {
+        if (componentsSplit)
+        {
+            components.reset(static_cast<int>(vertices.size()));
+            for (int from = 0; from < static_cast<int>(targets.size()); ++from)
+                for (const int to : targets[from])
+                    components.unite(from, to);
+            componentsSplit = false;
+        }
+        components.flatten();
+    });
+}
+
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::restride(const size_t newStride)
+{
+    vector<Weight> restrided;
+    restrided.reserve(newStride * newStride); // Rows up to the new stride are appended without reallocating
+    restrided.resize(vertices.size() * newStride, Weight());
+    for (size_t i = 0; i < vertices.size(); ++i)
+        copy_n(matrix.begin() + i * stride, vertices.size(), restrided.begin() + i * newStride);
+
+    matrix = move(restrided);
+    stride = newStride;
+}
+
+template <class VertexType, class Weight>
+bool Graph<VertexType, Weight>::vertexExists(const VertexType& vertex) const
+{
+    return indexes.contains(vertex);
 }
 
 template <class VertexType, class Weight>
 void Graph<VertexType, Weight>::updateIndexes()
 {
-    for (int i = 0; i < vertices.size(); ++i)
+    indexes.clear();
+    for (int i = 0; i < static_cast<int>(vertices.size()); ++i)
+    {
         vertices[i].index = i;
+        indexes.emplace(vertices[i].vertex, i);
+    }
 }
 
 template <class VertexType, class Weight>
 int Graph<VertexType, Weight>::getIndexForVertex(const VertexType& vertex) const
 {
-    for (auto currVertex : vertices)
-    {
-        if (currVertex.vertex == vertex)
-            return currVertex.index;
-    }
-    throw VertexNotFoundException<VertexType>(vertex);
+    const auto it = indexes.find(vertex);
+    if (it == indexes.end())
+        throw VertexNotFoundException<VertexType>(vertex);
+    return it->second;
 }
 
 template <class VertexType, class Weight>
-void Graph<VertexType, Weight>::addVertex(const VertexType& vertex)
+Graph<VertexType, Weight>::Graph(const vector<VertexType>& vertices, const vector<int>& offsets,
+                                 const vector<int>& neighbors, const vector<Weight>& weights)
 {
-    if (vertexExists(vertex)) return;
+    const int size = static_cast<int>(vertices.size());
+    this->vertices.reserve(size);
+    indexes.reserve(size);
+    for (int i = 0; i < size; ++i)
+    {
+        this->vertices.emplace_back(vertices[i], i);
+        indexes.emplace(vertices[i], i);
+    }
 
-    vertices.emplace_back(vertex, vertices.size());
-    matrix.emplace_back(vertices.size(), Weight());
-    for (auto& row : matrix)
+    // The stride addVertex would have doubled up to
+    stride = size > 0 ? bit_ceil(static_cast<size_t>(size)) : 0;
+    matrix.reserve(stride * stride);
+    matrix.resize(size * stride, Weight());
+    targets.resize(size);
+    sources.resize(size);
+    components.reset(size);
+    edgeCount = neighbors.size();
+
+    // Sources are scanned in ascending order, so every sources list comes out sorted
+    for (int from = 0; from < size; ++from)
     {
-        row.resize(vertices.size(), Weight());
+        targets[from].assign(neighbors.begin() + offsets[from], neighbors.begin() + offsets[from + 1]);
+        for (int e = offsets[from]; e < offsets[from + 1]; ++e)
+        {
+            weightAt(from, neighbors[e]) = weights[e];
+            sources[neighbors[e]].push_back(from);
+            components.unite(from, neighbors[e]);
+        }
     }
-    updateIndexes();
+    components.flatten();
+}
+
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::addVertex(const VertexType& vertex)
+{
+    const int index = static_cast<int>(vertices.size());
+    if (!indexes.emplace(vertex, index).second) return;
+
+    if (vertices.size() == stride)
+        restride(max<size_t>(1, 2 * stride));
+
+    vertices.emplace_back(vertex, index);
+    matrix.resize(vertices.size() * stride, Weight());
+    targets.emplace_back();
+    sources.emplace_back();
+    components.add();
+    dropIndexes();
 }
 
 template <class VertexType, class Weight>
@@ -262,12 +766,44 @@ void Graph<VertexType, Weight>::removeVertex(VertexType vertex)
 {
     const int index = getIndexForVertex(vertex);
 
-    vertices.erase(vertices.begin() + index);
+    const size_t size = vertices.size();
+    edgeCount -= targets[index].size() + sources[index].size() - (weightAt(index, index) != Weight() ? 1 : 0);
+
+    // Shift rows up and columns left over the removed index, in place. Rows before the removed
+    // one keep their place, so only their columns after it move; every other cell moves to an
+    // earlier position, where a forward copy never overwrites a cell it has yet to read.
+    for (size_t i = 0, row = 0; i < size; ++i)
+    {
+        if (i == static_cast<size_t>(index))
+            continue;
+        Weight* dest = matrix.data() + row * stride;
+        const Weight* src = matrix.data() + i * stride;
+        if (row != i)
+            copy(src, src + index, dest);
+        copy(src + index + 1, src + size, dest + index);
+        dest[size - 1] = Weight();
+        ++row;
+    }
+    matrix.resize((size - 1) * stride);
 
-    matrix.erase(matrix.begin() + index);
+    // Drop the removed index from the edge lists and shift the ones above it down
+    targets.erase(targets.begin() + index);
+    sources.erase(sources.begin() + index);
+    for (auto* lists : {&targets, &sources})
+    {
+        for (auto& list : *lists)
+        {
+            list.erase(remove(list.begin(), list.end(), index), list.end());
+            for (int& other : list)
+                if (other > index)
+                    --other;
+        }
+    }
 
-    for (auto& row : matrix)
-        row.erase(row.begin() + index);
+    vertices.erase(vertices.begin() + index);
+    componentsSplit = true;
+    componentsStale.set();
+    dropIndexes();
 
     updateIndexes();
 }
@@ -279,7 +815,7 @@ void Graph<VertexType, Weight>::addEdge(VertexType from, VertexType to, Weight w
     if (edgeExists(from, to))
         throw EdgeAlreadyExistsException<VertexType>(from, to);
 
-    matrix[getIndexForVertex(from)][getIndexForVertex(to)] = weight;
+    setWeight(getIndexForVertex(from), getIndexForVertex(to), weight);
 }
 
 template <class VertexType, class Weight>
@@ -287,7 +823,7 @@ void Graph<VertexType, Weight>::removeEdge(VertexType from, VertexType to)
 {
     validateEdge(from, to);
 
-    matrix[getIndexForVertex(from)][getIndexForVertex(to)] = Weight();
+    setWeight(getIndexForVertex(from), getIndexForVertex(to), Weight());
 }
 
 template <class VertexType, class Weight>
@@ -295,7 +831,7 @@ void Graph<VertexType, Weight>::updateWeight(VertexType from, VertexType to, con
 {
     validateEdge(from, to);
 
-    matrix[getIndexForVertex(from)][getIndexForVertex(to)] = val;
+    setWeight(getIndexForVertex(from), getIndexForVertex(to), val);
 }
 
 template <class VertexType, class Weight>
@@ -303,19 +839,17 @@ Weight Graph<VertexType, Weight>::getWeight(VertexType from, VertexType to) cons
 {
     validateEdge(from, to);
 
-    return matrix[getIndexForVertex(from)][getIndexForVertex(to)];
+    return weightAt(getIndexForVertex(from), getIndexForVertex(to));
 }
 
 template <class VertexType, class Weight>
 vector<VertexType> Graph<VertexType, Weight>::getDirectNeighbors(VertexType vertex) const
 {
-    if (not vertexExists(vertex))
-        throw VertexNotFoundException<VertexType>(vertex);
-
     vector<VertexType> directNeighbors;
-    for (auto currVertex : vertices)
-        if (matrix[getIndexForVertex(vertex)][getIndexForVertex(currVertex.vertex)] != Weight())
-            directNeighbors.push_back(currVertex.vertex);
+    forEachOutEdge(getIndexForVertex(vertex), [&](const int neighbor, const Weight&)
+    {
+        directNeighbors.push_back(vertices[neighbor].vertex);
+    });
 
     return directNeighbors;
 }
@@ -323,96 +857,369 @@ vector<VertexType> Graph<VertexType, Weight>::getDirectNeighbors(VertexType vert
 template <class VertexType, class Weight>
 vector<VertexType> Graph<VertexType, Weight>::getDirectSources(VertexType vertex) const
 {
-    if (not vertexExists(vertex))
-        throw VertexNotFoundException<VertexType>(vertex);
-
     vector<VertexType> directSources;
-    for (auto currVertex : vertices)
-        if (matrix[getIndexForVertex(currVertex.vertex)][getIndexForVertex(vertex)] != Weight())
-            directSources.push_back(currVertex.vertex);
+    forEachInEdge(getIndexForVertex(vertex), [&](const int source, const Weight&)
+    {
+        directSources.push_back(vertices[source].vertex);
+    });
 
     return directSources;
 }
 
 template <class VertexType, class Weight>
-vector<VertexType> Graph<VertexType, Weight>::getConnections(VertexType vertex, bool useBFS) const
+vector<VertexType> Graph<VertexType, Weight>::getReverseConnections(VertexType vertex) const
 {
-    vector<VertexType> result = useBFS ? performBFS(vertex) : performDFS(vertex);
-    result.erase(result.begin());
+    const vector<int>& reached = performBFS(getIndexForVertex(vertex), true);
+
+    vector<VertexType> result;
+    result.reserve(reached.size() - 1);
+    for (auto it = reached.begin() + 1; it != reached.end(); ++it) // Skip the target vertex
+        result.push_back(vertices[*it].vertex);
     return result;
 }
 
-template<class VertexType, class Weight>
-vector<VertexType> Graph<VertexType, Weight>::performBFS(const VertexType &vertex) const
+template <class VertexType, class Weight>
+vector<vector<VertexType>> Graph<VertexType, Weight>::getConnectionsBatch(const vector<VertexType>& sourceVertices,
+                                                                         const unsigned int threadCount) const
 {
-    const size_t startIndex = getIndexForVertex(vertex);
+    vector<vector<VertexType>> result(sourceVertices.size());
 
-    if (startIndex == static_cast<size_t>(-1))
-        return {};
+    // Every source has its own slot, so workers never write the same vector
+    forEachConnectionsBatch(sourceVertices, threadCount, [&](const size_t position, const vector<int>& reached)
+    {
+        result[position].reserve(reached.size());
+        for (const int vertex : reached)
+            result[position].push_back(vertices[vertex].vertex);
+    });
 
-    vector<bool> visited(vertices.size(), false);
+    return result;
+}
 
-    vector<VertexType> result;
-    VectorQueue<VertexType> queue;
+template <class VertexType, class Weight>
+template <class Visitor>
+void Graph<VertexType, Weight>::forEachConnectionsBatch(const vector<VertexType>& sourceVertices,
+                                                        const unsigned int threadCount, Visitor&& visit) const
+{
+    vector<int> starts;
+    starts.reserve(sourceVertices.size());
+    for (const auto& vertex : sourceVertices)
+        starts.push_back(getIndexForVertex(vertex));
 
-    visited[startIndex] = true;
-    queue.enqueue(vertex);
-    result.push_back(vertex); // Include starting vertex in the result
+    const int batchCount = static_cast<int>((starts.size() + MultiSourceBFS::BATCH_SIZE - 1) / MultiSourceBFS::BATCH_SIZE);
+    atomic<int> nextBatch{0};
 
-    while (!queue.isEmpty())
+    const auto worker = [&]()
     {
-        VertexType currVertex = queue.dequeue();
-
-        for (const auto& neighbor : getDirectNeighbors(currVertex))
+        MultiSourceBFS search;
+        vector<vector<int>> reached(MultiSourceBFS::BATCH_SIZE);
+        for (int batch = nextBatch++; batch < batchCount; batch = nextBatch++)
         {
-            size_t neighborIndex = getIndexForVertex(neighbor);
+            const int first = batch * MultiSourceBFS::BATCH_SIZE;
+            const int count = min<int>(MultiSourceBFS::BATCH_SIZE, static_cast<int>(starts.size()) - first);
 
-            if (!visited[neighborIndex])
+            for (auto& indexes : reached)
+                indexes.clear();
+            search.run(*this, starts.data() + first, count, [&](const int slot, const int vertex)
             {
-                visited[neighborIndex] = true;
-                queue.enqueue(neighbor);
-                result.push_back(neighbor);
-            }
+                reached[slot].push_back(vertex);
+            });
+
+            for (int slot = 0; slot < count; ++slot)
+                visit(static_cast<size_t>(first + slot), reached[slot]);
         }
-    }
+    };
+
+    vector<thread> threads;
+    for (unsigned int t = 1; t < max(1u, threadCount); ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads)
+        t.join();
+}
 
-    return result;
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::buildReachabilityIndex()
+{
+    reachability.emplace(*this);
 }
 
-template<class VertexType, class Weight>
-vector<VertexType> Graph<VertexType, Weight>::performDFS(const VertexType &vertex) const
+template <class VertexType, class Weight>
+bool Graph<VertexType, Weight>::hasReachabilityIndex() const
+{
+    return reachability.has_value();
+}
+
+template <class VertexType, class Weight>
+const TransitiveClosure& Graph<VertexType, Weight>::buildTransitiveClosure()
+{
+    return closure.emplace(*this);
+}
+
+template <class VertexType, class Weight>
+bool Graph<VertexType, Weight>::isReachable(VertexType from, VertexType to) const
+{
+    const int fromIndex = getIndexForVertex(from);
+    const int toIndex = getIndexForVertex(to);
+
+    if (closure)
+        return closure->isReachable(fromIndex, toIndex);
+    if (reachability)
+        return reachability->isReachable(fromIndex, toIndex);
+
+    const vector<int>& reached = performBFS(fromIndex);
+    return find(reached.begin() + 1, reached.end(), toIndex) != reached.end();
+}
+
+template <class VertexType, class Weight>
+vector<VertexType> Graph<VertexType, Weight>::getReachable(VertexType vertex) const
 {
-    const size_t startIndex = getIndexForVertex(vertex);
+    if (!closure and !reachability)
+        return getConnections(vertex);
+
+    const int index = getIndexForVertex(vertex);
 
-    if (startIndex == static_cast<size_t>(-1))
+    vector<VertexType> result;
+    for (const int reached : closure ? closure->reachableFrom(index) : reachability->reachableFrom(index))
+        result.push_back(vertices[reached].vertex);
+    return result;
+}
+
+template <class VertexType, class Weight>
+vector<VertexType> Graph<VertexType, Weight>::getConnections(VertexType vertex, bool useBFS,
+                                                              const unsigned int threadCount) const
+{
+    const int start = getIndexForVertex(vertex);
+    if (targets[start].empty()) // Isolated or a dead end: nothing to search
         return {};
 
-    vector<bool> visited(vertices.size(), false);
+    const vector<int>& reached = !useBFS ? performDFS(start)
+                                 : threadCount > 1 ? performParallelBFS(start, threadCount) : performBFS(start);
 
     vector<VertexType> result;
+    result.reserve(reached.size() - 1);
+    for (auto it = reached.begin() + 1; it != reached.end(); ++it) // Skip the starting vertex
+        result.push_back(vertices[*it].vertex);
+    return result;
+}
 
-    dfs_visit(vertex, visited, result);
+template <class VertexType, class Weight>
+int Graph<VertexType, Weight>::getComponentId(VertexType vertex) const
+{
+    const int index = getIndexForVertex(vertex);
+    refreshComponents();
+    return components.representative(index);
+}
 
+template <class VertexType, class Weight>
+bool Graph<VertexType, Weight>::inSameNetwork(VertexType a, VertexType b) const
+{
+    validateVertices(a, b);
+    return getComponentId(a) == getComponentId(b);
+}
+
+template <class VertexType, class Weight>
+int Graph<VertexType, Weight>::componentCount() const
+{
+    refreshComponents();
+    return components.countSets();
+}
+
+template <class VertexType, class Weight>
+vector<pair<VertexType, int>> Graph<VertexType, Weight>::getConnectionsWithinHops(VertexType vertex, const int maxHops) const
+{
+    vector<pair<VertexType, int>> result;
+    HopLimitedBFS::local().run(*this, getIndexForVertex(vertex), maxHops, [&](const int reached, const int hops)
+    {
+        result.emplace_back(vertices[reached].vertex, hops);
+    });
     return result;
 }
 
 template <class VertexType, class Weight>
-void Graph<VertexType, Weight>::dfs_visit(const VertexType &u, vector<bool> &visited, vector<VertexType> &result) const
+int Graph<VertexType, Weight>::vertexCount() const
+{
+    return static_cast<int>(vertices.size());
+}
+
+template <class VertexType, class Weight>
+const VertexType& Graph<VertexType, Weight>::getVertex(const int index) const
+{
+    return vertices[index].vertex;
+}
+
+template <class VertexType, class Weight>
+template <class Visitor>
+void Graph<VertexType, Weight>::forEachOutEdge(const int index, Visitor&& visit) const
+{
+    const Weight* row = &weightAt(index, 0);
+    for (const int neighbor : targets[index])
+        visit(neighbor, row[neighbor]);
+}
+
+template <class VertexType, class Weight>
+template <class Visitor>
+void Graph<VertexType, Weight>::forEachInEdge(const int index, Visitor&& visit) const
+{
+    for (const int source : sources[index])
+        visit(source, weightAt(source, index));
+}
+
+template <class VertexType, class Weight>
+const vector<int>& Graph<VertexType, Weight>::performBFS(const int start, const bool reverse) const
+{
+    // Top-down steps follow out-edges (in-edges in reverse), bottom-up steps scan the other way
+    const vector<vector<int>>& down = reverse ? sources : targets;
+    const vector<vector<int>>& up = reverse ? targets : sources;
+
+    TraversalWorkspace& workspace = TraversalWorkspace::local();
+    DirectionOptimizingBFS::run(vertexCount(), edgeCount, start,
+                                [&](const int v) -> const vector<int>& { return down[v]; },
+                                [&](const int v) -> const vector<int>& { return up[v]; }, workspace);
+    return workspace.order;
+}
+
+template <class VertexType, class Weight>
+const vector<int>& Graph<VertexType, Weight>::performParallelBFS(const int start, const unsigned int threadCount) const
 {
-    const size_t index = getIndexForVertex(u);
+    vector<int>& order = TraversalWorkspace::local().order;
+    ParallelBFS::local().run(*this, start, threadCount, order);
+    return order;
+}
 
-    if (visited[index]) return;
+template <class VertexType, class Weight>
+const vector<int>& Graph<VertexType, Weight>::performDFS(const int start) const
+{
+    TraversalWorkspace& workspace = TraversalWorkspace::local();
+    workspace.reset(vertexCount());
 
-    visited[index] = true;
-    result.push_back(u);
+    workspace.markVisited(start);
+    workspace.order.push_back(start);
+    workspace.stack.emplace_back(start, 0);
 
-    for (const auto& neighbor : getDirectNeighbors(u))
+    while (!workspace.stack.empty())
     {
-        if (!visited[getIndexForVertex(neighbor)])
+        auto& [u, cursor] = workspace.stack.back();
+
+        // Advance u's cursor to its next unvisited out-neighbor
+        const vector<int>& out = targets[u];
+        while (cursor < static_cast<int>(out.size()) && workspace.isVisited(out[cursor]))
+            ++cursor;
+
+        if (cursor == static_cast<int>(out.size()))
         {
-            dfs_visit(neighbor, visited, result);
+            workspace.stack.pop_back();
+            continue;
         }
+
+        const int neighbor = out[cursor++];
+        workspace.markVisited(neighbor);
+        workspace.order.push_back(neighbor);
+        workspace.stack.emplace_back(neighbor, 0); // Invalidates u and cursor
     }
+
+    return workspace.order;
+}
+
+template <class VertexType, class Weight>
+ShortestPathTree Graph<VertexType, Weight>::travelTimes(VertexType from) const requires unsigned_integral<Weight>
+{
+    return ShortestPathTree(*this, getIndexForVertex(from));
+}
+
+template <class VertexType, class Weight>
+vector<pair<VertexType, uint64_t>> Graph<VertexType, Weight>::reachableWithin(VertexType vertex, const uint64_t maxMinutes)
+    const requires unsigned_integral<Weight>
+{
+    vector<pair<VertexType, uint64_t>> result;
+    IsochroneSearch::local().run(*this, getIndexForVertex(vertex), maxMinutes, [&](const int reached, const uint64_t time)
+    {
+        result.emplace_back(vertices[reached].vertex, time);
+    });
+    return result;
+}
+
+template <class VertexType, class Weight>
+TravelTimeMatrix Graph<VertexType, Weight>::allPairsTravelTimes(const unsigned int threadCount) const
+    requires unsigned_integral<Weight>
+{
+    return TravelTimeMatrix(*this, threadCount);
+}
+
+template <class VertexType, class Weight>
+Route<VertexType> Graph<VertexType, Weight>::shortestPath(VertexType from, VertexType to) const
+    requires unsigned_integral<Weight>
+{
+    BidirectionalSearch& search = BidirectionalSearch::local();
+    Route<VertexType> route{{}, search.run(*this, getIndexForVertex(from), getIndexForVertex(to))};
+
+    vector<int> stops;
+    search.getRoute(stops);
+    for (const int stop : stops)
+        route.stops.push_back(vertices[stop].vertex);
+    return route;
+}
+
+template <class VertexType, class Weight>
+uint64_t Graph<VertexType, Weight>::travelTime(VertexType from, VertexType to) const requires unsigned_integral<Weight>
+{
+    if (hierarchy)
+        return hierarchy->travelTime(getIndexForVertex(from), getIndexForVertex(to));
+    if (landmarks)
+        return AStarSearch::local().run(*this, *landmarks, getIndexForVertex(from), getIndexForVertex(to));
+    return BidirectionalSearch::local().run(*this, getIndexForVertex(from), getIndexForVertex(to));
+}
+
+template <class VertexType, class Weight>
+const ContractionHierarchy& Graph<VertexType, Weight>::buildContractionHierarchy() requires unsigned_integral<Weight>
+{
+    return hierarchy.emplace(*this);
+}
+
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::useContractionHierarchy(ContractionHierarchy loaded) requires unsigned_integral<Weight>
+{
+    if (loaded.vertexCount() != vertexCount())
+        throw invalid_argument("Error: Contraction hierarchy does not match the graph");
+    hierarchy = std::move(loaded);
+}
+
+template <class VertexType, class Weight>
+const LandmarkIndex& Graph<VertexType, Weight>::buildLandmarks(const int count) requires unsigned_integral<Weight>
+{
+    return landmarks.emplace(*this, count);
+}
+
+template <class VertexType, class Weight>
+CompactGraph<VertexType, Weight> Graph<VertexType, Weight>::freeze() const
+{
+    vector<VertexType> frozenVertices;
+    vector<int> offsets;
+    vector<int> neighbors;
+    vector<Weight> weights;
+
+    frozenVertices.reserve(vertices.size());
+    offsets.reserve(vertices.size() + 1);
+    offsets.push_back(0);
+
+    for (int i = 0; i < vertexCount(); ++i)
+    {
+        frozenVertices.push_back(vertices[i].vertex);
+        forEachOutEdge(i, [&](const int neighbor, const Weight& weight)
+        {
+            neighbors.push_back(neighbor);
+            weights.push_back(weight);
+        });
+        offsets.push_back(static_cast<int>(neighbors.size()));
+    }
+
+    return CompactGraph<VertexType, Weight>(move(frozenVertices), move(offsets), move(neighbors), move(weights));
+}
+
+template <class VertexType, class Weight>
+void Graph<VertexType, Weight>::saveSnapshot(const string& fileName) const
+    requires same_as<VertexType, string> && is_trivially_copyable_v<Weight>
+{
+    freeze().saveSnapshot(fileName);
 }
 
 template <class VertexType, class Weight>
@@ -443,7 +1250,7 @@ void Graph<VertexType, Weight>::print(int) const
         cout << setw(colWidthInt) << left << vertices[i].vertex << "|"; // Print vertex
         for (size_t j = 0; j < vertices.size(); ++j)
         {
-            cout << setw(colWidthInt) << right << matrix[i][j]; // Print weights
+            cout << setw(colWidthInt) << right << weightAt(static_cast<int>(i), static_cast<int>(j)); // Print weights
         }
         cout << endl;
     }
@@ -452,22 +1259,19 @@ void Graph<VertexType, Weight>::print(int) const
 template<class VertexType, class Weight>
 void Graph<VertexType, Weight>::print() const
 {
-    for (int i = 0; i < vertices.size(); ++i)
+    for (int i = 0; i < vertexCount(); ++i)
     {
-        vector<VertexType> neighbor = getDirectNeighbors(vertices[i].vertex);
-
         cout << vertices[i].vertex << ": ";
 
-        if (neighbor.empty())
-            continue;
-
-
-        for (const auto& n : neighbor)
+        bool hasNeighbors = false;
+        forEachOutEdge(i, [&](const int neighbor, const Weight&)
         {
-            cout << n << " ";
-        }
+            cout << vertices[neighbor].vertex << " ";
+            hasNeighbors = true;
+        });
 
-        cout << endl;
+        if (hasNeighbors)
+            cout << endl;
     }
 }
 
@@ -0,0 +1,179 @@
+#ifndef GRAPHBUILDER_H
+#define GRAPHBUILDER_H
+
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Graph.h"
+
+using namespace std;
+
+/**
+ * Collects the vertices and edges of a graph in bulk, then builds the <i>Graph</i> in one pass,
+ * instead of validating and inserting every edge into the matrix on its own.
+ * Vertices are interned once, in order of first appearance, and edges are kept as
+ * <i>(source index, target index, weight)</i> triples. <i>build()</i> radix-sorts the triples by
+ * source and target, folds each run of duplicates and hands the result to <i>Graph</i> as CSR arrays.
+ * Duplicates fold the way <i>Parser</i> applies repeated lines to a graph: the smallest weight wins,
+ * and <i>Weight()</i>, the graph's "no edge", drops the weights before it.
+ * @tparam VertexType The vertex type. Same requirements as in <i>Graph</i>.
+ * @tparam Weight The weight type. Same requirements as in <i>Graph</i>, and <i>&lt;</i> to fold duplicates.
+ */
+template <class VertexType, class Weight>
+class GraphBuilder
+{
+private:
+    /**
+     * An edge by vertex indexes
+     */
+    struct Triple
+    {
+        int source;
+        int target;
+        Weight weight;
+    };
+
+    vector<VertexType> vertices; /* The vertices, in order of first appearance */
+    unordered_map<VertexType, int> indexes; /* Maps each vertex to its index in vertices */
+    vector<Triple> triples; /* Every added edge, duplicates included, in order of addition */
+
+    /**
+     * Stable counting sort of <i>from</i> into <i>to</i> by <i>key(triple)</i>, a vertex index.
+     * @return <i>vertices.size() + 1</i> offsets: the triples with key <i>k</i> end up at <i>[offsets[k], offsets[k + 1])</i>.
+     */
+    template <class Key>
+    vector<int> countingSort(const vector<Triple>& from, vector<Triple>& to, Key key) const;
+
+public:
+    GraphBuilder() = default;
+    ~GraphBuilder() = default;
+    GraphBuilder(const GraphBuilder& other) = default;
+    GraphBuilder(GraphBuilder&& other) noexcept = default;
+    GraphBuilder& operator=(const GraphBuilder& other) = default;
+    GraphBuilder& operator=(GraphBuilder&& other) noexcept = default;
+
+    /**
+     * Adds a vertex, unless it was already added.
+     * @param vertex The vertex.
+     * @return The vertex's index, in <i>build()</i>'s graph too.
+     */
+    int addVertex(const VertexType& vertex);
+
+    /**
+     * Adds an edge. A duplicate is allowed and folded by <i>build()</i>.
+     * @param source The index of the source vertex, from <i>addVertex</i>.
+     * @param target The index of the target vertex, from <i>addVertex</i>.
+     * @param weight The weight of the edge, <i>Weight()</i> for none.
+     */
+    void addEdge(int source, int target, const Weight& weight);
+
+    /**
+     * Reserves room for <i>count</i> more edges.
+     * @param count Number of edges about to be added.
+     */
+    void reserveEdges(size_t count);
+
+    /**
+     * @return The number of vertices added.
+     */
+    int vertexCount() const;
+
+    /**
+     * Builds the graph, leaving the builder empty.
+     * @return A graph with the added vertices, by index, and the folded edges.
+     */
+    Graph<VertexType, Weight> build();
+};
+
+
+// Implementation
+
+template <class VertexType, class Weight>
+int GraphBuilder<VertexType, Weight>::addVertex(const VertexType& vertex)
+{
+    const auto [it, added] = indexes.try_emplace(vertex, static_cast<int>(vertices.size()));
+    if (added)
+        vertices.push_back(vertex);
+    return it->second;
+}
+
+template <class VertexType, class Weight>
+void GraphBuilder<VertexType, Weight>::addEdge(const int source, const int target, const Weight& weight)
+{
+    triples.push_back({source, target, weight});
+}
+
+template <class VertexType, class Weight>
+void GraphBuilder<VertexType, Weight>::reserveEdges(const size_t count)
+{
+    triples.reserve(triples.size() + count);
+}
+
+template <class VertexType, class Weight>
+int GraphBuilder<VertexType, Weight>::vertexCount() const
+{
+    return static_cast<int>(vertices.size());
+}
+
+template <class VertexType, class Weight>
+template <class Key>
+vector<int> GraphBuilder<VertexType, Weight>::countingSort(const vector<Triple>& from, vector<Triple>& to, Key key) const
+{
+    vector<int> offsets(vertices.size() + 1, 0);
+    for (const Triple& triple : from)
+        ++offsets[key(triple) + 1];
+    for (size_t i = 1; i < offsets.size(); ++i)
+        offsets[i] += offsets[i - 1];
+
+    to.resize(from.size());
+    vector<int> next(offsets.begin(), offsets.end() - 1);
+    for (const Triple& triple : from)
+        to[next[key(triple)]++] = triple;
+    return offsets;
+}
+
+template <class VertexType, class Weight>
+Graph<VertexType, Weight> GraphBuilder<VertexType, Weight>::build()
+{
+    // LSD radix sort with one digit per vertex index: by target, then stably by source
+    vector<Triple> byTarget;
+    countingSort(triples, byTarget, [](const Triple& triple) { return triple.target; });
+    const vector<int> groups = countingSort(byTarget, triples, [](const Triple& triple) { return triple.source; });
+    byTarget = vector<Triple>();
+
+    // Each run of duplicates is contiguous, still in order of addition
+    vector<int> offsets{0};
+    vector<int> neighbors;
+    vector<Weight> weights;
+    offsets.reserve(vertices.size() + 1);
+    neighbors.reserve(triples.size());
+    weights.reserve(triples.size());
+    for (size_t source = 0; source < vertices.size(); ++source)
+    {
+        for (int i = groups[source]; i < groups[source + 1];)
+        {
+            const int target = triples[i].target;
+            Weight weight = triples[i].weight;
+            for (++i; i < groups[source + 1] && triples[i].target == target; ++i)
+            {
+                const Weight& next = triples[i].weight;
+                if (weight == Weight() || next == Weight() || next < weight)
+                    weight = next;
+            }
+
+            if (weight != Weight())
+            {
+                neighbors.push_back(target);
+                weights.push_back(weight);
+            }
+        }
+        offsets.push_back(static_cast<int>(neighbors.size()));
+    }
+
+    Graph<VertexType, Weight> graph(vertices, offsets, neighbors, weights);
+    *this = GraphBuilder();
+    return graph;
+}
+
+#endif //GRAPHBUILDER_H
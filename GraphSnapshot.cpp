@@ -0,0 +1,205 @@
+#include "GraphSnapshot.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <stdexcept>
+
+#include "Checksum.h"
+
+namespace
+{
+    constexpr char FILE_MAGIC[8] = {'H', 'W', '5', 'S', 'N', 'A', 'P', '\0'};
+    constexpr std::size_t ALIGNMENT = 8;
+
+    /**
+     * The start of a snapshot file
+     */
+    struct Header
+    {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t weightSize;
+        std::uint64_t vertexCount;
+        std::uint64_t edgeCount;
+        std::uint64_t nameBytes;
+        std::uint64_t checksum; /* Of everything after the header */
+    };
+
+    /**
+     * Where each section of a snapshot starts, from the start of the file
+     */
+    struct Layout
+    {
+        std::size_t nameOffsets, names, offsets, neighbors, weights, reverseOffsets, reverseSources, reverseWeights;
+        std::size_t end;
+    };
+
+    std::size_t aligned(const std::size_t position)
+    {
+        return (position + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT;
+    }
+
+    /**
+     * Lays the sections out back to back, each on an <i>ALIGNMENT</i> boundary.
+     * The counts must be small enough not to overflow, as checked by the reader.
+     */
+    Layout layOut(const Header& header)
+    {
+        const std::size_t vertexCount = header.vertexCount;
+        const std::size_t edgeCount = header.edgeCount;
+        Layout layout{};
+        layout.nameOffsets = aligned(sizeof(Header));
+        layout.names = aligned(layout.nameOffsets + (vertexCount + 1) * sizeof(std::uint64_t));
+        layout.offsets = aligned(layout.names + header.nameBytes);
+        layout.neighbors = aligned(layout.offsets + (vertexCount + 1) * sizeof(int));
+        layout.weights = aligned(layout.neighbors + edgeCount * sizeof(int));
+        layout.reverseOffsets = aligned(layout.weights + edgeCount * header.weightSize);
+        layout.reverseSources = aligned(layout.reverseOffsets + (vertexCount + 1) * sizeof(int));
+        layout.reverseWeights = aligned(layout.reverseSources + edgeCount * sizeof(int));
+        layout.end = aligned(layout.reverseWeights + edgeCount * header.weightSize);
+        return layout;
+    }
+
+    /**
+     * Checks that <i>offsets</i> starts at 0, never decreases and ends at <i>targets.size()</i>,
+     * and that every target is a vertex index.
+     */
+    bool validCsr(const std::span<const int> offsets, const std::span<const int> targets, const int vertexCount)
+    {
+        if (offsets.front() != 0 || offsets.back() != static_cast<int>(targets.size()))
+            return false;
+        if (std::adjacent_find(offsets.begin(), offsets.end(), std::greater<>()) != offsets.end())
+            return false;
+        return std::all_of(targets.begin(), targets.end(), [&](const int target)
+        {
+            return target >= 0 && target < vertexCount;
+        });
+    }
+
+    template <class Element>
+    std::span<const Element> sectionAt(const std::string_view contents, const std::size_t start, const std::size_t count)
+    {
+        return {reinterpret_cast<const Element*>(contents.data() + start), count};
+    }
+}
+
+GraphSnapshot::GraphSnapshot(const std::string& fileName, const std::size_t weightSize) : file(fileName)
+{
+    const std::string_view contents = file.contents();
+    const auto invalid = [&]()
+    {
+        return std::invalid_argument("Error: Not a valid graph snapshot file " + fileName);
+    };
+
+    Header header{};
+    if (contents.size() < sizeof(Header))
+        throw invalid();
+    std::memcpy(&header, contents.data(), sizeof(Header));
+
+    // Bounding the counts by the file size first keeps the layout arithmetic from overflowing
+    if (!std::equal(header.magic, header.magic + sizeof(header.magic), FILE_MAGIC) ||
+        header.version != FILE_VERSION || header.weightSize != weightSize ||
+        header.vertexCount >= INT_MAX || header.edgeCount > INT_MAX || header.nameBytes > contents.size())
+        throw invalid();
+
+    const Layout layout = layOut(header);
+    if (layout.end != contents.size() || checksum(contents.substr(sizeof(Header))) != header.checksum)
+        throw invalid();
+
+    const std::size_t vertices = header.vertexCount;
+    const std::size_t edges = header.edgeCount;
+    nameOffsets = sectionAt<std::uint64_t>(contents, layout.nameOffsets, vertices + 1);
+    names = contents.substr(layout.names, header.nameBytes);
+    offsets = sectionAt<int>(contents, layout.offsets, vertices + 1);
+    neighbors = sectionAt<int>(contents, layout.neighbors, edges);
+    weights = reinterpret_cast<const std::byte*>(contents.data() + layout.weights);
+    reverseOffsets = sectionAt<int>(contents, layout.reverseOffsets, vertices + 1);
+    reverseSources = sectionAt<int>(contents, layout.reverseSources, edges);
+    reverseWeights = reinterpret_cast<const std::byte*>(contents.data() + layout.reverseWeights);
+
+    if (nameOffsets.front() != 0 || nameOffsets.back() != header.nameBytes ||
+        std::adjacent_find(nameOffsets.begin(), nameOffsets.end(), std::greater<>()) != nameOffsets.end() ||
+        !validCsr(offsets, neighbors, vertexCount()) || !validCsr(reverseOffsets, reverseSources, vertexCount()))
+        throw invalid();
+}
+
+void GraphSnapshot::save(const std::string& fileName, const std::vector<std::string>& vertexNames,
+                         const std::span<const int> offsets, const std::span<const int> neighbors,
+                         const std::span<const std::byte> weights, const std::span<const int> reverseOffsets,
+                         const std::span<const int> reverseSources, const std::span<const std::byte> reverseWeights,
+                         const std::size_t weightSize)
+{
+    std::vector<std::uint64_t> nameOffsets{0};
+    for (const std::string& name : vertexNames)
+        nameOffsets.push_back(nameOffsets.back() + name.size());
+
+    Header header{};
+    std::copy(FILE_MAGIC, FILE_MAGIC + sizeof(FILE_MAGIC), header.magic);
+    header.version = FILE_VERSION;
+    header.weightSize = static_cast<std::uint32_t>(weightSize);
+    header.vertexCount = vertexNames.size();
+    header.edgeCount = neighbors.size();
+    header.nameBytes = nameOffsets.back();
+
+    // The checksum comes first in the file, so the rest is laid out in memory before writing
+    const Layout layout = layOut(header);
+    std::string body(layout.end - sizeof(Header), '\0');
+    const auto place = [&](const std::size_t start, const void* data, const std::size_t size)
+    {
+        if (size > 0)
+            std::memcpy(body.data() + (start - sizeof(Header)), data, size);
+    };
+    place(layout.nameOffsets, nameOffsets.data(), nameOffsets.size() * sizeof(std::uint64_t));
+    for (std::size_t i = 0; i < vertexNames.size(); ++i)
+        place(layout.names + nameOffsets[i], vertexNames[i].data(), vertexNames[i].size());
+    place(layout.offsets, offsets.data(), offsets.size_bytes());
+    place(layout.neighbors, neighbors.data(), neighbors.size_bytes());
+    place(layout.weights, weights.data(), weights.size());
+    place(layout.reverseOffsets, reverseOffsets.data(), reverseOffsets.size_bytes());
+    place(layout.reverseSources, reverseSources.data(), reverseSources.size_bytes());
+    place(layout.reverseWeights, reverseWeights.data(), reverseWeights.size());
+    header.checksum = checksum(body);
+
+    std::ofstream out(fileName, std::ios::binary);
+    if (!out)
+        throw std::invalid_argument("Error: Could not open file " + fileName);
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(body.data(), static_cast<std::streamsize>(body.size()));
+
+    if (!out)
+        throw std::invalid_argument("Error: Could not write file " + fileName);
+}
+
+int GraphSnapshot::vertexCount() const
+{
+    return static_cast<int>(nameOffsets.size() - 1);
+}
+
+std::string_view GraphSnapshot::getName(const int index) const
+{
+    return names.substr(nameOffsets[index], nameOffsets[index + 1] - nameOffsets[index]);
+}
+
+std::span<const int> GraphSnapshot::getOffsets() const
+{
+    return offsets;
+}
+
+std::span<const int> GraphSnapshot::getNeighbors() const
+{
+    return neighbors;
+}
+
+std::span<const int> GraphSnapshot::getReverseOffsets() const
+{
+    return reverseOffsets;
+}
+
+std::span<const int> GraphSnapshot::getReverseSources() const
+{
+    return reverseSources;
+}
@@ -0,0 +1,130 @@
+#ifndef GRAPHSNAPSHOT_H
+#define GRAPHSNAPSHOT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "MappedFile.h"
+
+/**
+ * A graph saved in binary form, for starting without re-parsing the input files.
+ * The file holds a header (magic, format version, counts and a checksum of the rest), the vertex
+ * name table, then the CSR arrays of a <i>CompactGraph</i>: out-edges and in-edges, each as offsets,
+ * neighbors and weights. Every section starts on an 8-byte boundary, so once the file is
+ * memory-mapped the arrays are used where they lie, without a per-edge copy.
+ * The arrays are in the byte order of the machine that wrote them.
+ */
+class GraphSnapshot
+{
+private:
+    static constexpr std::uint32_t FILE_VERSION = 1;
+
+    MappedFile file;
+    std::span<const std::uint64_t> nameOffsets; /* Start of each name in names, plus a trailing end offset */
+    std::string_view names; /* The vertex names, back to back */
+    std::span<const int> offsets;
+    std::span<const int> neighbors;
+    const std::byte* weights{nullptr};
+    std::span<const int> reverseOffsets;
+    std::span<const int> reverseSources;
+    const std::byte* reverseWeights{nullptr};
+
+public:
+    /**
+     * Maps a snapshot written by <i>save</i> and checks it: header, checksum and array bounds.
+     * @param fileName The file to read.
+     * @param weightSize The size of the expected weight type.
+     * @throws std::invalid_argument If the file cannot be read or is not a valid snapshot with
+     * weights of <i>weightSize</i> bytes.
+     */
+    GraphSnapshot(const std::string& fileName, std::size_t weightSize);
+    ~GraphSnapshot() = default;
+    // The arrays point into the file's memory, so a snapshot stays where it was loaded
+    GraphSnapshot(const GraphSnapshot& other) = delete;
+    GraphSnapshot(GraphSnapshot&& other) = delete;
+    GraphSnapshot& operator=(const GraphSnapshot& other) = delete;
+    GraphSnapshot& operator=(GraphSnapshot&& other) = delete;
+
+    /**
+     * Writes a snapshot of a graph given as CSR arrays, as <i>CompactGraph</i> holds them.
+     * @param fileName The file to write.
+     * @param vertexNames The vertex names, by index.
+     * @param offsets <i>vertexNames.size() + 1</i> offsets into <i>neighbors</i>.
+     * @param neighbors Out-edge targets, grouped by source.
+     * @param weights Out-edge weights, parallel to <i>neighbors</i>, as raw bytes.
+     * @param reverseOffsets <i>vertexNames.size() + 1</i> offsets into <i>reverseSources</i>.
+     * @param reverseSources In-edge sources, grouped by target.
+     * @param reverseWeights In-edge weights, parallel to <i>reverseSources</i>, as raw bytes.
+     * @param weightSize The size of one weight.
+     * @throws std::invalid_argument If the file cannot be written.
+     */
+    static void save(const std::string& fileName, const std::vector<std::string>& vertexNames,
+                     std::span<const int> offsets, std::span<const int> neighbors, std::span<const std::byte> weights,
+                     std::span<const int> reverseOffsets, std::span<const int> reverseSources,
+                     std::span<const std::byte> reverseWeights, std::size_t weightSize);
+
+    /**
+     * @return The number of vertices.
+     */
+    int vertexCount() const;
+
+    /**
+     * @param index A valid vertex index.
+     * @return The name of the vertex at <i>index</i>, valid while the snapshot lives.
+     */
+    std::string_view getName(int index) const;
+
+    /**
+     * @return <i>vertexCount() + 1</i> offsets into <i>getNeighbors()</i>.
+     */
+    std::span<const int> getOffsets() const;
+
+    /**
+     * @return Out-edge targets, grouped by source.
+     */
+    std::span<const int> getNeighbors() const;
+
+    /**
+     * @return <i>vertexCount() + 1</i> offsets into <i>getReverseSources()</i>.
+     */
+    std::span<const int> getReverseOffsets() const;
+
+    /**
+     * @return In-edge sources, grouped by target.
+     */
+    std::span<const int> getReverseSources() const;
+
+    /**
+     * @tparam Weight The weight type, of the size given to the constructor.
+     * @return The out-edge weights, parallel to <i>getNeighbors()</i>.
+     */
+    template <class Weight>
+    std::span<const Weight> getWeights() const;
+
+    /**
+     * @tparam Weight The weight type, of the size given to the constructor.
+     * @return The in-edge weights, parallel to <i>getReverseSources()</i>.
+     */
+    template <class Weight>
+    std::span<const Weight> getReverseWeights() const;
+};
+
+template <class Weight>
+std::span<const Weight> GraphSnapshot::getWeights() const
+{
+    static_assert(alignof(Weight) <= 8, "Sections are only 8-byte aligned");
+    return {reinterpret_cast<const Weight*>(weights), neighbors.size()};
+}
+
+template <class Weight>
+std::span<const Weight> GraphSnapshot::getReverseWeights() const
+{
+    static_assert(alignof(Weight) <= 8, "Sections are only 8-byte aligned");
+    return {reinterpret_cast<const Weight*>(reverseWeights), reverseSources.size()};
+}
+
+#endif //GRAPHSNAPSHOT_H
@@ -0,0 +1,7 @@
+#include "HopLimitedBFS.h"
+
+HopLimitedBFS& HopLimitedBFS::local()
+{
+    thread_local HopLimitedBFS search;
+    return search;
+}
@@ -0,0 +1,123 @@
+#ifndef HOPLIMITEDBFS_H
+#define HOPLIMITEDBFS_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Breadth-first search that stops after a given number of levels (hops), reporting each vertex's
+ * hop count as it is found.
+ * Levels are expanded one at a time. A level is held as a list of vertices while it is small,
+ * and as a bitset of the vertices once the list would outgrow the bitset (one bit per vertex
+ * against 32 per list entry); a bitset level is expanded by scanning its words in index order.
+ * The scratch buffers are kept between searches; use one instance per thread, e.g. <i>local()</i>.
+ */
+class HopLimitedBFS
+{
+private:
+    std::vector<std::uint64_t> visited; /* Bit v: v has been reached */
+    std::vector<std::uint64_t> frontierBits; /* Bit v: v is in the current level, if it is dense */
+    std::vector<std::uint64_t> nextBits; /* Bit v: v is in the next level, if it is dense */
+    std::vector<int> frontier; /* The current level, if it is sparse */
+    std::vector<int> next; /* The next level, if it is sparse */
+
+public:
+    HopLimitedBFS() = default;
+    ~HopLimitedBFS() = default;
+    HopLimitedBFS(const HopLimitedBFS& other) = default;
+    HopLimitedBFS(HopLimitedBFS&& other) noexcept = default;
+    HopLimitedBFS& operator=(const HopLimitedBFS& other) = default;
+    HopLimitedBFS& operator=(HopLimitedBFS&& other) noexcept = default;
+
+    /**
+     * Searches from <i>source</i> for at most <i>maxHops</i> levels.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>.
+     * @param graph The graph to search.
+     * @param source A valid vertex index.
+     * @param maxHops The number of levels to expand.
+     * @param reached Callable taking <i>(int vertex, int hops)</i>, called once for every vertex
+     * other than <i>source</i> within <i>maxHops</i> edges of it, level by level.
+     */
+    template <class GraphType, class Visitor>
+    void run(const GraphType& graph, int source, int maxHops, Visitor&& reached);
+
+    /**
+     * @return The calling thread's instance.
+     */
+    static HopLimitedBFS& local();
+};
+
+template <class GraphType, class Visitor>
+void HopLimitedBFS::run(const GraphType& graph, const int source, const int maxHops, Visitor&& reached)
+{
+    const int size = graph.vertexCount();
+    const std::size_t words = (static_cast<std::size_t>(size) + 63) / 64;
+    const std::size_t denseThreshold = static_cast<std::size_t>(size) / 32;
+    visited.assign(words, 0);
+    frontierBits.assign(words, 0);
+    nextBits.assign(words, 0);
+    frontier.assign(1, source);
+    next.clear();
+    visited[source / 64] |= std::uint64_t{1} << (source % 64);
+
+    bool frontierDense = false;
+    for (int hops = 1; hops <= maxHops; ++hops)
+    {
+        bool nextDense = false;
+        std::size_t nextCount = 0;
+
+        const auto expand = [&](const int v)
+        {
+            graph.forEachOutEdge(v, [&](const int neighbor, const auto&)
+            {
+                const std::uint64_t bit = std::uint64_t{1} << (neighbor % 64);
+                if (visited[neighbor / 64] & bit)
+                    return;
+                visited[neighbor / 64] |= bit;
+                reached(neighbor, hops);
+
+                if (!nextDense && ++nextCount > denseThreshold)
+                {
+                    // The list would outgrow a bitset: move the level over
+                    for (const int listed : next)
+                        nextBits[listed / 64] |= std::uint64_t{1} << (listed % 64);
+                    next.clear();
+                    nextDense = true;
+                }
+                if (nextDense)
+                    nextBits[neighbor / 64] |= bit;
+                else
+                    next.push_back(neighbor);
+            });
+        };
+
+        if (frontierDense)
+        {
+            for (std::size_t w = 0; w < words; ++w)
+            {
+                for (std::uint64_t bits = frontierBits[w]; bits != 0; bits &= bits - 1)
+                    expand(static_cast<int>(w * 64) + std::countr_zero(bits));
+                frontierBits[w] = 0;
+            }
+        }
+        else
+        {
+            for (const int v : frontier)
+                expand(v);
+        }
+
+        if (nextDense)
+            std::swap(frontierBits, nextBits);
+        else
+            std::swap(frontier, next);
+        next.clear();
+        frontierDense = nextDense;
+
+        if (!frontierDense && frontier.empty())
+            break;
+    }
+}
+
+#endif //HOPLIMITEDBFS_H
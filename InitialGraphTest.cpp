@@ -1,6 +1,9 @@
+#include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <string>
 #include "Graph.h"
+#include "RecordScanner.h"
 #include "VectorQueue.h"
 
 /**
@@ -16,6 +19,14 @@ struct City {
     friend ostream& operator<<(ostream& os, const City& city) { return os << city.name; }
 };
 
+/**
+ * Hashes a city by its name, so it can be used as a graph vertex.
+ */
+template <>
+struct std::hash<City> {
+    size_t operator()(const City& city) const noexcept { return hash<string>()(city.name); }
+};
+
 /**
  * Represents the distance of a road in kilometers.
  */
@@ -149,9 +160,698 @@ void test_graph()
 
         // Final BFS/DFS test
         testConnections(newYork);
+
+        // Frozen (CSR) copy must answer the same
+        cout << endl << "Frozen graph:" << endl;
+        const CompactGraph<City, RoadDistance> frozenGraph = cityGraph.freeze();
+        frozenGraph.print();
+        cout << "BFS Connections from " << newYork << ": ";
+        for (const auto& conn : frozenGraph.getConnections(newYork, true))
+            cout << conn << " ";
+        cout << endl;
+        cout << "DFS Connections from " << newYork << ": ";
+        for (const auto& conn : frozenGraph.getConnections(newYork, false))
+            cout << conn << " ";
+        cout << endl;
+
+        // Backward reachability, and the SCC index answering the same set as BFS
+        cout << endl << "Cities reaching " << miami << ": ";
+        for (const auto& conn : cityGraph.getReverseConnections(miami))
+            cout << conn << " ";
+        cout << endl;
+
+        cityGraph.addEdge(miami, newYork, RoadDistance(2100));
+        cityGraph.buildReachabilityIndex();
+        cout << "Indexed connections from " << chicago << ": ";
+        for (const auto& conn : cityGraph.getReachable(chicago))
+            cout << conn << " ";
+        cout << endl;
+        cityGraph.removeEdge(miami, newYork);
+        cout << "Index dropped after removing an edge? " << (cityGraph.hasReachabilityIndex() ? "No" : "Yes") << endl;
     }
     catch (const exception& e)
     {
         cerr << "Unexpected error: " << e.what() << endl;
     }
 }
+
+/**
+ * Builds a random network of <i>vertexCount</i> stations "S0".."S<i>n-1</i>" with about <i>edgeCount</i>
+ * edges of hop times 1 to 20.
+ * @param seed The generator state, advanced by the call.
+ */
+Graph<string, unsigned int> randomNetwork(const int vertexCount, const int edgeCount, unsigned int& seed)
+{
+    Graph<string, unsigned int> graph;
+    for (int i = 0; i < vertexCount; ++i)
+        graph.addVertex("S" + to_string(i));
+
+    for (int e = 0; e < edgeCount; ++e)
+    {
+        seed = seed * 1103515245 + 12345;
+        const string from = "S" + to_string((seed >> 8) % vertexCount);
+        const string to = "S" + to_string((seed >> 16) % vertexCount);
+        const vector<string> neighbors = graph.getDirectNeighbors(from);
+        if (from != to && find(neighbors.begin(), neighbors.end(), to) == neighbors.end())
+            graph.addEdge(from, to, 1 + (seed >> 24) % 20);
+    }
+    return graph;
+}
+
+/**
+ * Runs plain Dijkstra (<i>travelTimes</i>) from every station, and counts the pairs of stations
+ * <i>from</i>, <i>to</i> for which <i>matches(from, to, tree)</i> is false, <i>tree</i> being the
+ * Dijkstra tree from <i>from</i>.
+ */
+template <class Matches>
+int countDijkstraMismatches(const Graph<string, unsigned int>& graph, Matches&& matches)
+{
+    int mismatches = 0;
+    for (int from = 0; from < graph.vertexCount(); ++from)
+    {
+        const ShortestPathTree tree = graph.travelTimes(graph.getVertex(from));
+        for (int to = 0; to < graph.vertexCount(); ++to)
+            if (!matches(from, to, tree))
+                ++mismatches;
+    }
+    return mismatches;
+}
+
+/**
+ * Counts the pairs of stations whose <i>travelTime</i> differs from plain Dijkstra.
+ */
+int countTravelTimeMismatches(const Graph<string, unsigned int>& graph)
+{
+    return countDijkstraMismatches(graph, [&](const int from, const int to, const ShortestPathTree& tree)
+    {
+        return graph.travelTime(graph.getVertex(from), graph.getVertex(to)) == tree.timeTo(to);
+    });
+}
+
+/**
+ * Counts the pairs of stations whose <i>shortestPath</i> (bidirectional Dijkstra) differs from plain
+ * Dijkstra: in travel time, or in a route that does not follow edges adding up to that time.
+ */
+int countRouteMismatches(const Graph<string, unsigned int>& graph)
+{
+    return countDijkstraMismatches(graph, [&](const int from, const int to, const ShortestPathTree& tree)
+    {
+        const Route<string> route = graph.shortestPath(graph.getVertex(from), graph.getVertex(to));
+        uint64_t routeTime = 0;
+        for (size_t stop = 1; stop < route.stops.size(); ++stop)
+            routeTime += graph.getWeight(route.stops[stop - 1], route.stops[stop]);
+
+        const bool reachable = tree.timeTo(to) != ShortestPathTree::UNREACHABLE;
+        return route.time == tree.timeTo(to) && route.stops.empty() != reachable &&
+               (!reachable || (route.stops.front() == graph.getVertex(from) &&
+                               route.stops.back() == graph.getVertex(to) && routeTime == route.time));
+    });
+}
+
+/**
+ * Counts the cells of a <i>TravelTimeMatrix</i> built by <i>method</i> that differ from plain Dijkstra.
+ */
+int countMatrixMismatches(const Graph<string, unsigned int>& graph, const TravelTimeMatrix::Method method)
+{
+    const TravelTimeMatrix matrix(graph, 2, method);
+    return countDijkstraMismatches(graph, [&](const int from, const int to, const ShortestPathTree& tree)
+    {
+        return matrix.timeAt(from, to) == min<uint64_t>(tree.timeTo(to), TravelTimeMatrix::UNREACHABLE);
+    });
+}
+
+/**
+ * Compares every travel-time search with plain Dijkstra on small random networks: bidirectional
+ * Dijkstra, landmarks and a contraction hierarchy, then after weight updates, which must not leave
+ * stale tables answering. Also compares both all-pairs methods, on networks of several matrix tiles.
+ * @return The number of mismatches.
+ */
+int testTravelTimes()
+{
+    unsigned int seed = 12345;
+    int bidirectionalMismatches = 0;
+    int landmarkMismatches = 0;
+    int hierarchyMismatches = 0;
+    int updateMismatches = 0;
+
+    for (int round = 0; round < 200; ++round)
+    {
+        Graph<string, unsigned int> graph = randomNetwork(12, 36, seed);
+        bidirectionalMismatches += countTravelTimeMismatches(graph) + countRouteMismatches(graph);
+        graph.buildLandmarks(3);
+        landmarkMismatches += countTravelTimeMismatches(graph);
+        graph.buildContractionHierarchy();
+        hierarchyMismatches += countTravelTimeMismatches(graph);
+
+        for (int updates = 0; updates < 5;)
+        {
+            seed = seed * 1103515245 + 12345;
+            const string from = graph.getVertex(static_cast<int>((seed >> 8) % 12));
+            const vector<string> neighbors = graph.getDirectNeighbors(from);
+            if (neighbors.empty())
+                continue;
+            graph.updateWeight(from, neighbors[(seed >> 16) % neighbors.size()], 1 + (seed >> 24) % 20);
+            ++updates;
+        }
+        updateMismatches += countTravelTimeMismatches(graph);
+
+        graph.buildLandmarks(3);
+        landmarkMismatches += countTravelTimeMismatches(graph);
+        graph.buildContractionHierarchy();
+        hierarchyMismatches += countTravelTimeMismatches(graph);
+    }
+
+    int floydWarshallMismatches = 0;
+    int repeatedDijkstraMismatches = 0;
+    for (int round = 0; round < 5; ++round)
+    {
+        const Graph<string, unsigned int> graph = randomNetwork(150, 600, seed);
+        floydWarshallMismatches += countMatrixMismatches(graph, TravelTimeMatrix::Method::FLOYD_WARSHALL);
+        repeatedDijkstraMismatches += countMatrixMismatches(graph, TravelTimeMatrix::Method::DIJKSTRA);
+    }
+
+    cout << "Bidirectional mismatches against Dijkstra: " << bidirectionalMismatches << endl;
+    cout << "Landmark (A*) mismatches against Dijkstra: " << landmarkMismatches << endl;
+    cout << "Contraction hierarchy mismatches against Dijkstra: " << hierarchyMismatches << endl;
+    cout << "Mismatches after weight updates: " << updateMismatches << endl;
+    cout << "Floyd-Warshall matrix mismatches against Dijkstra: " << floydWarshallMismatches << endl;
+    cout << "Repeated-Dijkstra matrix mismatches against Dijkstra: " << repeatedDijkstraMismatches << endl;
+    return bidirectionalMismatches + landmarkMismatches + hierarchyMismatches + updateMismatches +
+           floydWarshallMismatches + repeatedDijkstraMismatches;
+}
+
+/**
+ * Checks a list of stations reached from <i>from</i> within <i>limit</i> against a reference search:
+ * it must hold exactly the stations other than <i>from</i> whose reference cost is at most
+ * <i>limit</i>, each once, at that cost, by ascending cost.
+ * @param listed The stations and their costs, as returned by the query under test.
+ * @param reference Callable taking a station's index and returning its cost from <i>from</i>,
+ * or a cost above <i>limit</i> if the reference search did not reach it.
+ */
+template <class Cost, class Reference>
+bool matchesReference(const Graph<string, unsigned int>& graph, const int from,
+                      const vector<pair<string, Cost>>& listed, const uint64_t limit, Reference&& reference)
+{
+    size_t expectedCount = 0;
+    for (int to = 0; to < graph.vertexCount(); ++to)
+        if (to != from && static_cast<uint64_t>(reference(to)) <= limit)
+            ++expectedCount;
+
+    vector<bool> seen(graph.vertexCount(), false);
+    bool matches = listed.size() == expectedCount;
+    for (size_t i = 0; matches && i < listed.size(); ++i)
+    {
+        const int to = graph.getIndexForVertex(listed[i].first);
+        const auto cost = static_cast<uint64_t>(listed[i].second);
+        matches = to != from && !seen[to] && cost == reference(to) && cost <= limit &&
+                  (i == 0 || listed[i - 1].second <= listed[i].second);
+        seen[to] = true;
+    }
+    return matches;
+}
+
+/**
+ * Compares <i>reachableWithin</i> with plain Dijkstra on random networks, from every station and for
+ * several budgets, 0 included.
+ * @return The number of mismatching queries.
+ */
+int testIsochrones()
+{
+    unsigned int seed = 12345;
+    int mismatches = 0;
+
+    for (int round = 0; round < 20; ++round)
+    {
+        const Graph<string, unsigned int> graph = randomNetwork(40, 120, seed);
+        for (int from = 0; from < graph.vertexCount(); ++from)
+        {
+            const ShortestPathTree tree = graph.travelTimes(graph.getVertex(from));
+            for (const uint64_t budget : {0, 1, 5, 15, 30, 60, 1000})
+            {
+                const vector<pair<string, uint64_t>> within = graph.reachableWithin(graph.getVertex(from), budget);
+                if (!matchesReference(graph, from, within, budget, [&](const int to) { return tree.timeTo(to); }))
+                    ++mismatches;
+            }
+        }
+    }
+
+    cout << "Isochrone mismatches against Dijkstra: " << mismatches << endl;
+    return mismatches;
+}
+
+/**
+ * Breadth-first search with a plain queue.
+ * @param neighbors Callable taking a station and returning the stations to enqueue from it, in order.
+ * @param hops Receives each station's hop count from <i>start</i>, -1 if unreached.
+ * @return The reached stations' indexes in queue order, <i>start</i> first.
+ */
+template <class Neighbors>
+vector<int> queueBFS(const Graph<string, unsigned int>& graph, const int start, Neighbors&& neighbors,
+                     vector<int>& hops)
+{
+    hops.assign(graph.vertexCount(), -1);
+    hops[start] = 0;
+    vector<int> order{start};
+    for (size_t head = 0; head < order.size(); ++head)
+    {
+        for (const string& next : neighbors(graph.getVertex(order[head])))
+        {
+            const int index = graph.getIndexForVertex(next);
+            if (hops[index] == -1)
+            {
+                hops[index] = hops[order[head]] + 1;
+                order.push_back(index);
+            }
+        }
+    }
+    return order;
+}
+
+/**
+ * Counts the queries <i>getConnectionsWithinHops(from, k)</i>, for k = 0 to 3, that do not list exactly
+ * the stations 1 to k hops from <i>from</i> by a queue BFS, at that hop count and by ascending hops.
+ */
+int countHopMismatches(const Graph<string, unsigned int>& graph, const int from)
+{
+    vector<int> hops;
+    queueBFS(graph, from, [&](const string& vertex) { return graph.getDirectNeighbors(vertex); }, hops);
+    const auto hopsTo = [&](const int to) { return hops[to] == -1 ? UINT64_MAX : static_cast<uint64_t>(hops[to]); };
+
+    int mismatches = 0;
+    for (int maxHops = 0; maxHops <= 3; ++maxHops)
+    {
+        const vector<pair<string, int>> within = graph.getConnectionsWithinHops(graph.getVertex(from), maxHops);
+        if (!matchesReference(graph, from, within, maxHops, hopsTo))
+            ++mismatches;
+    }
+    return mismatches;
+}
+
+/**
+ * Compares <i>getConnectionsWithinHops</i> with a queue BFS for k = 0 to 3. On an hourglass network,
+ * a hub's level outgrows the list into a bitset, narrows back to a list at the waist, then grows
+ * into a bitset again. Random networks of 2000 stations with about 8 departures each have bitset
+ * levels by the second hop, so the third expands one.
+ * @return The number of mismatching queries.
+ */
+int testHopLimits()
+{
+    // S0 -> S1..S200 -> S201..S210 -> S211..S999, the bitset threshold being 1000 / 32 stations
+    Graph<string, unsigned int> hourglass;
+    for (int i = 0; i < 1000; ++i)
+        hourglass.addVertex("S" + to_string(i));
+    for (int i = 1; i <= 200; ++i)
+    {
+        hourglass.addEdge("S0", "S" + to_string(i), 1);
+        hourglass.addEdge("S" + to_string(i), "S" + to_string(201 + i % 10), 1);
+    }
+    for (int i = 211; i < 1000; ++i)
+        hourglass.addEdge("S" + to_string(201 + i % 10), "S" + to_string(i), 1);
+
+    int mismatches = countHopMismatches(hourglass, 0);
+
+    unsigned int seed = 12345;
+    for (int round = 0; round < 3; ++round)
+    {
+        const Graph<string, unsigned int> graph = randomNetwork(2000, 16000, seed);
+        for (int from = 0; from < graph.vertexCount(); from += 97)
+            mismatches += countHopMismatches(graph, from);
+    }
+
+    cout << "Hop-limited mismatches against a queue BFS: " << mismatches << endl;
+    return mismatches;
+}
+
+/**
+ * Compares <i>getConnections</i> and <i>getReverseConnections</i>, both direction-optimizing, with a
+ * queue BFS from every station: the same stations in the same order, on <i>Graph</i> and on its frozen
+ * <i>CompactGraph</i>. The networks average 20 departures per station, so after two levels most edges
+ * lead into the frontier and the search switches to bottom-up steps.
+ * @return The number of mismatching searches.
+ */
+int testDirectionOptimizingBFS()
+{
+    unsigned int seed = 12345;
+    int forwardMismatches = 0;
+    int reverseMismatches = 0;
+
+    for (int round = 0; round < 5; ++round)
+    {
+        const Graph<string, unsigned int> graph = randomNetwork(300, 6500, seed);
+        const CompactGraph<string, unsigned int> frozenGraph = graph.freeze();
+        for (int from = 0; from < graph.vertexCount(); ++from)
+        {
+            const string& vertex = graph.getVertex(from);
+            for (const bool reverse : {false, true})
+            {
+                vector<int> hops;
+                const vector<int> expected = queueBFS(graph, from, [&](const string& v)
+                {
+                    return reverse ? graph.getDirectSources(v) : graph.getDirectNeighbors(v);
+                }, hops);
+
+                const auto matches = [&](const vector<string>& reached)
+                {
+                    bool same = reached.size() + 1 == expected.size();
+                    for (size_t i = 0; same && i < reached.size(); ++i)
+                        same = graph.getIndexForVertex(reached[i]) == expected[i + 1];
+                    return same;
+                };
+                if (!matches(reverse ? graph.getReverseConnections(vertex) : graph.getConnections(vertex)))
+                    ++(reverse ? reverseMismatches : forwardMismatches);
+                if (!matches(reverse ? frozenGraph.getReverseConnections(vertex) : frozenGraph.getConnections(vertex)))
+                    ++(reverse ? reverseMismatches : forwardMismatches);
+            }
+        }
+    }
+
+    cout << "Direction-optimizing BFS mismatches against a queue BFS: " << forwardMismatches << endl;
+    cout << "Direction-optimizing reverse BFS mismatches against a queue BFS: " << reverseMismatches << endl;
+    return forwardMismatches + reverseMismatches;
+}
+
+/**
+ * Compares multi-threaded <i>getConnections</i> with a queue BFS, on <i>Graph</i> and on its frozen
+ * <i>CompactGraph</i>, for 2 to 4 threads: the same stations, level by level. Order within a level
+ * depends on thread timing, so only the set of stations and their levels are compared. The levels
+ * outgrow the 256-vertex chunks threads claim, so several threads share a level.
+ * @return The number of mismatching searches.
+ */
+int testParallelBFS()
+{
+    unsigned int seed = 12345;
+    int mismatches = 0;
+
+    for (int round = 0; round < 3; ++round)
+    {
+        const Graph<string, unsigned int> graph = randomNetwork(3000, 12000, seed);
+        const CompactGraph<string, unsigned int> frozenGraph = graph.freeze();
+        for (int from = 0; from < graph.vertexCount(); from += 250)
+        {
+            vector<int> hops;
+            vector<int> expected = queueBFS(graph, from, [&](const string& v)
+            {
+                return graph.getDirectNeighbors(v);
+            }, hops);
+            expected.erase(expected.begin()); // getConnections leaves out the start
+            sort(expected.begin(), expected.end());
+
+            const auto matches = [&](const vector<string>& reached)
+            {
+                vector<int> indexes;
+                for (const string& station : reached)
+                    indexes.push_back(graph.getIndexForVertex(station));
+                for (size_t i = 1; i < indexes.size(); ++i)
+                    if (hops[indexes[i]] < hops[indexes[i - 1]])
+                        return false;
+                sort(indexes.begin(), indexes.end());
+                return indexes == expected;
+            };
+            for (unsigned int threads = 2; threads <= 4; ++threads)
+            {
+                const string& vertex = graph.getVertex(from);
+                if (!matches(graph.getConnections(vertex, true, threads)))
+                    ++mismatches;
+                if (!matches(frozenGraph.getConnections(vertex, true, threads)))
+                    ++mismatches;
+            }
+        }
+    }
+
+    cout << "Multi-threaded BFS mismatches against a queue BFS: " << mismatches << endl;
+    return mismatches;
+}
+
+/**
+ * Counts the pairs of stations on which <i>inSameNetwork</i> disagrees with a queue BFS that follows
+ * edges in both directions, plus one if <i>componentCount</i> disagrees with it.
+ */
+int countComponentMismatches(const Graph<string, unsigned int>& graph)
+{
+    const auto bothWays = [&](const string& vertex)
+    {
+        vector<string> linked = graph.getDirectNeighbors(vertex);
+        const vector<string> sources = graph.getDirectSources(vertex);
+        linked.insert(linked.end(), sources.begin(), sources.end());
+        return linked;
+    };
+
+    const int size = graph.vertexCount();
+    vector<int> labels(size, -1);
+    int labelCount = 0;
+    for (int v = 0; v < size; ++v)
+    {
+        if (labels[v] != -1)
+            continue;
+        vector<int> hops;
+        for (const int reached : queueBFS(graph, v, bothWays, hops))
+            labels[reached] = labelCount;
+        ++labelCount;
+    }
+
+    int mismatches = graph.componentCount() != labelCount ? 1 : 0;
+    for (int a = 0; a < size; ++a)
+        for (int b = 0; b < size; ++b)
+            if (graph.inSameNetwork(graph.getVertex(a), graph.getVertex(b)) != (labels[a] == labels[b]))
+                ++mismatches;
+    return mismatches;
+}
+
+/**
+ * Compares the weakly connected components with a queue BFS on sparse random networks: after loading,
+ * after edge and vertex removals, where the first lookup rebuilds them, and after more edges merge
+ * components that were already looked up. The first lookup after the removals also comes from several
+ * threads at once, which must all see the rebuilt components.
+ * @return The number of mismatches.
+ */
+int testComponents()
+{
+    unsigned int seed = 12345;
+    int loadMismatches = 0;
+    int removalMismatches = 0;
+    int concurrentMismatches = 0;
+    int additionMismatches = 0;
+
+    for (int round = 0; round < 100; ++round)
+    {
+        Graph<string, unsigned int> graph = randomNetwork(30, 25, seed);
+        loadMismatches += countComponentMismatches(graph);
+
+        for (int removals = 0; removals < 5;)
+        {
+            seed = seed * 1103515245 + 12345;
+            const string from = graph.getVertex(static_cast<int>((seed >> 8) % graph.vertexCount()));
+            const vector<string> neighbors = graph.getDirectNeighbors(from);
+            if (neighbors.empty())
+                continue;
+            graph.removeEdge(from, neighbors[(seed >> 16) % neighbors.size()]);
+            ++removals;
+        }
+        seed = seed * 1103515245 + 12345;
+        graph.removeVertex(graph.getVertex(static_cast<int>((seed >> 8) % graph.vertexCount())));
+
+        // Every thread's first lookup may find the components stale
+        vector<int> expected(graph.vertexCount());
+        vector<vector<int>> seen(4, vector<int>(graph.vertexCount()));
+        vector<thread> threads;
+        for (auto& ids : seen)
+            threads.emplace_back([&graph, &ids]()
+            {
+                for (int v = 0; v < graph.vertexCount(); ++v)
+                    ids[v] = graph.getComponentId(graph.getVertex(v));
+            });
+        for (auto& t : threads)
+            t.join();
+        for (int v = 0; v < graph.vertexCount(); ++v)
+            expected[v] = graph.getComponentId(graph.getVertex(v));
+        for (const auto& ids : seen)
+            if (ids != expected)
+                ++concurrentMismatches;
+
+        removalMismatches += countComponentMismatches(graph);
+
+        for (int additions = 0; additions < 5;)
+        {
+            seed = seed * 1103515245 + 12345;
+            const string from = graph.getVertex(static_cast<int>((seed >> 8) % graph.vertexCount()));
+            const string to = graph.getVertex(static_cast<int>((seed >> 16) % graph.vertexCount()));
+            const vector<string> neighbors = graph.getDirectNeighbors(from);
+            if (from == to || find(neighbors.begin(), neighbors.end(), to) != neighbors.end())
+                continue;
+            graph.addEdge(from, to, 1);
+            ++additions;
+        }
+        additionMismatches += countComponentMismatches(graph);
+    }
+
+    cout << "Component mismatches against a queue BFS after loading: " << loadMismatches << endl;
+    cout << "Component mismatches against a queue BFS after removals: " << removalMismatches << endl;
+    cout << "Concurrent first lookups disagreeing after removals: " << concurrentMismatches << endl;
+    cout << "Component mismatches against a queue BFS after additions: " << additionMismatches << endl;
+    return loadMismatches + removalMismatches + concurrentMismatches + additionMismatches;
+}
+
+/**
+ * Times loading a line network of <i>vertexCount</i> stations, as the parser would build it: first into
+ * a row-per-vertex matrix grown the way <i>addVertex</i> used to grow it (before), then into <i>Graph</i> (after).
+ * @param vertexCount Number of stations to load.
+ */
+void benchmarkLoad(const int vertexCount)
+{
+    const auto beforeBegin = chrono::steady_clock::now();
+
+    // The former layout: one vector per row, and every row resized by each new vertex
+    vector<vector<unsigned int>> rows;
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        rows.emplace_back(i + 1, 0u);
+        for (auto& row : rows)
+            row.resize(i + 1, 0u);
+        if (i > 0)
+            rows[i - 1][i] = 1 + i % 10;
+    }
+
+    const auto beforeEnd = chrono::steady_clock::now();
+    const auto begin = chrono::steady_clock::now();
+
+    Graph<string, unsigned int> graph;
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        graph.addVertex("S" + to_string(i));
+        if (i > 0)
+            graph.addEdge("S" + to_string(i - 1), "S" + to_string(i), 1 + i % 10);
+    }
+
+    const auto loaded = chrono::steady_clock::now();
+    const size_t reached = graph.getConnections("S0").size();
+    const auto end = chrono::steady_clock::now();
+
+    cout << "Loaded " << vertexCount << " vertices into row-per-vertex matrix (before) in "
+         << chrono::duration_cast<chrono::milliseconds>(beforeEnd - beforeBegin).count() << " ms, into Graph (after) in "
+         << chrono::duration_cast<chrono::milliseconds>(loaded - begin).count() << " ms, BFS reached "
+         << reached << " in " << chrono::duration_cast<chrono::milliseconds>(end - loaded).count() << " ms" << endl;
+}
+
+/**
+ * Times <i>getConnections</i> with 1 to <i>maxThreads</i> threads, on a frozen random network of
+ * <i>vertexCount</i> stations with 4 departures each, too large for the dense matrix of <i>Graph</i>.
+ * Reports a mismatch if a thread count reaches other stations than 1 thread does.
+ * @param vertexCount Number of stations.
+ * @param maxThreads Largest number of threads to try.
+ */
+void benchmarkParallelBFS(const int vertexCount, const unsigned int maxThreads)
+{
+    vector<string> stations;
+    vector<int> offsets{0};
+    vector<int> neighbors;
+    vector<unsigned int> hopTimes;
+    unsigned int seed = 12345;
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        stations.push_back("S" + to_string(i));
+
+        vector<int> departures;
+        for (int d = 0; d < 4; ++d)
+        {
+            seed = seed * 1103515245 + 12345;
+            departures.push_back(static_cast<int>((seed >> 8) % vertexCount));
+        }
+        sort(departures.begin(), departures.end());
+        departures.erase(unique(departures.begin(), departures.end()), departures.end());
+
+        neighbors.insert(neighbors.end(), departures.begin(), departures.end());
+        hopTimes.insert(hopTimes.end(), departures.size(), 1 + i % 10);
+        offsets.push_back(static_cast<int>(neighbors.size()));
+    }
+    const CompactGraph<string, unsigned int> graph(stations, offsets, neighbors, hopTimes);
+
+    vector<string> singleThreaded;
+    for (unsigned int threads = 1; threads <= maxThreads; ++threads)
+    {
+        const auto begin = chrono::steady_clock::now();
+        vector<string> reached = graph.getConnections("S0", true, threads);
+        const auto end = chrono::steady_clock::now();
+
+        // Order within a level varies with more threads, the set of stations must not
+        sort(reached.begin(), reached.end());
+        if (threads == 1)
+            singleThreaded = reached;
+
+        cout << threads << " thread(s): BFS reached " << reached.size() << " of " << vertexCount << " in "
+             << chrono::duration_cast<chrono::milliseconds>(end - begin).count() << " ms"
+             << (reached == singleThreaded ? "" : ", MISMATCH against 1 thread") << endl;
+    }
+}
+
+/**
+ * Times <i>RecordScanner</i> with every instruction set the CPU supports, on <i>megabytes</i> MB of
+ * generated edge lines, and prints the throughput in GB/s: first of finding the delimiters alone,
+ * then of also parsing every hop time.
+ * @param megabytes Size of the generated input.
+ */
+void benchmarkRecordScanner(const int megabytes)
+{
+    string text;
+    unsigned int seed = 12345;
+    while (text.size() < static_cast<size_t>(megabytes) << 20)
+    {
+        seed = seed * 1103515245 + 12345;
+        text += "S" + to_string((seed >> 8) % 5000) + "\tS" + to_string((seed >> 4) % 5000) + "\t" +
+                to_string(1 + (seed >> 16) % 90) + "\n";
+    }
+    vector<uint32_t> delimiters(text.size());
+
+    const auto gigabytesPerSecond = [&](const chrono::steady_clock::duration elapsed)
+    {
+        return static_cast<double>(text.size()) / 1e9 / chrono::duration<double>(elapsed).count();
+    };
+
+    for (const auto instructionSet : {RecordScanner::InstructionSet::SCALAR, RecordScanner::InstructionSet::SSE2,
+                                      RecordScanner::InstructionSet::AVX2})
+    {
+        if (!RecordScanner::isSupported(instructionSet))
+            continue;
+        const RecordScanner scanner(instructionSet);
+
+        const auto begin = chrono::steady_clock::now();
+        const size_t count = scanner.findDelimiters(text, delimiters.data());
+        const auto scanned = chrono::steady_clock::now();
+
+        // Every third delimiter ends a line; the hop time sits between it and the one before
+        unsigned long long totalHopTime = 0;
+        for (size_t i = 2; i < count; i += 3)
+        {
+            const string_view field(text.data() + delimiters[i - 1] + 1, delimiters[i] - delimiters[i - 1] - 1);
+            unsigned int hopTime = 0;
+            RecordScanner::parseShortNumber(field, hopTime);
+            totalHopTime += hopTime;
+        }
+        const auto end = chrono::steady_clock::now();
+
+        const char* names[] = {"scalar", "SSE2", "AVX2"};
+        cout << names[static_cast<int>(instructionSet)] << ": " << count << " delimiters at "
+             << gigabytesPerSecond(scanned - begin) << " GB/s, with hop times (total " << totalHopTime << ") at "
+             << gigabytesPerSecond(end - begin) << " GB/s" << endl;
+    }
+}
+
+/**
+ * Runs the checks above, and the benchmarks too when given <i>--benchmark</i>.
+ * @return <i>EXIT_FAILURE</i> if a check found a mismatch.
+ */
+int main(const int argc, char** argv)
+{
+    testQueue();
+    test_graph();
+    const int mismatches = testTravelTimes() + testIsochrones() + testHopLimits() +
+                           testDirectionOptimizingBFS() + testParallelBFS() + testComponents();
+
+    if (argc > 1 && string(argv[1]) == "--benchmark")
+    {
+        benchmarkLoad(10000);
+        benchmarkParallelBFS(400000, 4);
+        benchmarkRecordScanner(256);
+    }
+
+    return mismatches == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,14 @@
+#include "IsochroneSearch.h"
+
+void IsochroneSearch::reset(const int vertexCount)
+{
+    stamps.reset(vertexCount);
+    if (times.size() < stamps.size())
+        times.resize(stamps.size());
+}
+
+IsochroneSearch& IsochroneSearch::local()
+{
+    thread_local IsochroneSearch search;
+    return search;
+}
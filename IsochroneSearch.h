@@ -0,0 +1,79 @@
+#ifndef ISOCHRONESEARCH_H
+#define ISOCHRONESEARCH_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Dijkstra.h"
+#include "EpochStamps.h"
+#include "RadixHeap.h"
+
+/**
+ * Every vertex within a travel-time budget of a source, by Dijkstra's algorithm cut off at the
+ * budget: arrivals past it are never queued, so the search touches only the vertices inside the
+ * isochrone and their out-edges, however large the rest of the graph is.
+ * Scratch buffers are kept between queries and reset by epoch stamps, so repeated queries
+ * on one graph do not allocate; use one instance per thread, e.g. <i>local()</i>.
+ */
+class IsochroneSearch
+{
+private:
+    RadixHeap queue;
+    std::vector<std::uint64_t> times; /* Tentative travel times, valid where stamped */
+    EpochStamps stamps; /* The vertices reached by the current query */
+
+    void reset(int vertexCount);
+
+public:
+    IsochroneSearch() = default;
+    ~IsochroneSearch() = default;
+    IsochroneSearch(const IsochroneSearch& other) = default;
+    IsochroneSearch(IsochroneSearch&& other) noexcept = default;
+    IsochroneSearch& operator=(const IsochroneSearch& other) = default;
+    IsochroneSearch& operator=(IsochroneSearch&& other) noexcept = default;
+
+    /**
+     * Finds the vertices reachable from <i>source</i> within <i>budget</i>.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>
+     * with unsigned integer weights.
+     * @param graph The graph to search.
+     * @param source A valid vertex index.
+     * @param budget The largest travel time to report.
+     * @param reached Callable taking <i>(int vertex, std::uint64_t time)</i>, called once for every
+     * vertex other than <i>source</i> with a shortest travel time of at most <i>budget</i>,
+     * by ascending time.
+     */
+    template <class GraphType, class Visitor>
+    void run(const GraphType& graph, int source, std::uint64_t budget, Visitor&& reached);
+
+    /**
+     * @return The calling thread's instance.
+     */
+    static IsochroneSearch& local();
+};
+
+template <class GraphType, class Visitor>
+void IsochroneSearch::run(const GraphType& graph, const int source, const std::uint64_t budget, Visitor&& reached)
+{
+    reset(graph.vertexCount());
+
+    // A vertex's time is unset until its first stamp of the query
+    const auto timeOf = [&](const int vertex) -> std::uint64_t&
+    {
+        if (stamps.mark(vertex))
+            times[vertex] = std::numeric_limits<std::uint64_t>::max();
+        return times[vertex];
+    };
+
+    dijkstra(graph, source, queue, timeOf,
+             [&](const int vertex, const std::uint64_t time)
+             {
+                 if (vertex != source)
+                     reached(vertex, time);
+                 return true;
+             },
+             [](int, int) {}, budget);
+}
+
+#endif //ISOCHRONESEARCH_H
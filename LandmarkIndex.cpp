@@ -0,0 +1,127 @@
+#include "LandmarkIndex.h"
+
+#include <algorithm>
+
+#include "Dijkstra.h"
+#include "RadixHeap.h"
+#include "ShortestPathTree.h"
+
+namespace
+{
+    /**
+     * Dijkstra's algorithm over the out-edges of <i>graph</i>.
+     * @return The travel time from <i>source</i> to every vertex, UNREACHABLE if none.
+     */
+    std::vector<std::uint64_t> travelTimes(const CsrGraph& graph, const int source, RadixHeap& queue)
+    {
+        std::vector<std::uint64_t> times(graph.vertexCount(), ShortestPathTree::UNREACHABLE);
+        dijkstra(graph, source, queue,
+                 [&](const int vertex) -> std::uint64_t& { return times[vertex]; },
+                 [](int, std::uint64_t) { return true; },
+                 [](int, int) {});
+        return times;
+    }
+}
+
+void LandmarkIndex::build(const CsrGraph& graph, const CsrGraph& reverse, const int count)
+{
+    const int size = graph.vertexCount();
+    landmarkCount = std::min(count, size);
+    landmarks.clear();
+    fromLandmark.assign(static_cast<std::size_t>(size) * landmarkCount, NO_DISTANCE);
+    toLandmark.assign(static_cast<std::size_t>(size) * landmarkCount, NO_DISTANCE);
+    if (landmarkCount == 0)
+        return;
+
+    // spread[v]: round-trip time between v and its nearest landmark, UNREACHABLE if no landmark
+    // connects with v. Seeded from vertex 0, so the first landmark is the vertex farthest from it.
+    std::vector<std::uint64_t> spread(size, ShortestPathTree::UNREACHABLE);
+    RadixHeap queue;
+
+    const auto addToSpread = [&](const std::vector<std::uint64_t>& from, const std::vector<std::uint64_t>& to)
+    {
+        for (int v = 0; v < size; ++v)
+        {
+            if (from[v] != ShortestPathTree::UNREACHABLE && to[v] != ShortestPathTree::UNREACHABLE)
+                spread[v] = std::min(spread[v], from[v] + to[v]);
+            else if (from[v] != ShortestPathTree::UNREACHABLE || to[v] != ShortestPathTree::UNREACHABLE)
+                spread[v] = std::min(spread[v], ShortestPathTree::UNREACHABLE - 1);
+        }
+    };
+
+    addToSpread(travelTimes(graph, 0, queue), travelTimes(reverse, 0, queue));
+
+    for (int i = 0; i < landmarkCount; ++i)
+    {
+        // Chosen landmarks have a spread of 0, and are never chosen again
+        const int landmark = static_cast<int>(std::max_element(spread.begin(), spread.end()) - spread.begin());
+        landmarks.push_back(landmark);
+
+        const std::vector<std::uint64_t> from = travelTimes(graph, landmark, queue);
+        const std::vector<std::uint64_t> to = travelTimes(reverse, landmark, queue);
+
+        // NO_DISTANCE must mean "no route" for lowerBound. A landmark with a route too long for
+        // 32 bits keeps NO_DISTANCE everywhere instead, so it bounds nothing.
+        const auto fits = [](const std::uint64_t time)
+        {
+            return time == ShortestPathTree::UNREACHABLE || time < NO_DISTANCE;
+        };
+        if (std::all_of(from.begin(), from.end(), fits) && std::all_of(to.begin(), to.end(), fits))
+        {
+            for (int v = 0; v < size; ++v)
+            {
+                const std::size_t cell = static_cast<std::size_t>(v) * landmarkCount + i;
+                fromLandmark[cell] = static_cast<std::uint32_t>(std::min<std::uint64_t>(from[v], NO_DISTANCE));
+                toLandmark[cell] = static_cast<std::uint32_t>(std::min<std::uint64_t>(to[v], NO_DISTANCE));
+            }
+        }
+
+        addToSpread(from, to);
+        spread[landmark] = 0;
+    }
+}
+
+int LandmarkIndex::vertexCount() const
+{
+    return landmarkCount == 0 ? 0 : static_cast<int>(fromLandmark.size() / landmarkCount);
+}
+
+const std::vector<int>& LandmarkIndex::getLandmarks() const
+{
+    return landmarks;
+}
+
+std::size_t LandmarkIndex::memoryUsage() const
+{
+    return (fromLandmark.size() + toLandmark.size()) * sizeof(std::uint32_t);
+}
+
+std::uint64_t LandmarkIndex::lowerBound(const int vertex, const int target) const
+{
+    const std::uint32_t* vertexFrom = fromLandmark.data() + static_cast<std::size_t>(vertex) * landmarkCount;
+    const std::uint32_t* targetFrom = fromLandmark.data() + static_cast<std::size_t>(target) * landmarkCount;
+    const std::uint32_t* vertexTo = toLandmark.data() + static_cast<std::size_t>(vertex) * landmarkCount;
+    const std::uint32_t* targetTo = toLandmark.data() + static_cast<std::size_t>(target) * landmarkCount;
+
+    // Whether a landmark is used depends on the target alone, so every vertex of one query gets the
+    // same set of terms. Each term, d(L, t) - d(L, v) or d(v, L) - d(t, L), is consistent by the
+    // triangle inequality, and so is the maximum of consistent terms and 0. The unknown cases:
+    // - d(L, v) unknown: v is unreachable from L. The term is then dropped for v; that cannot break
+    //   consistency on an edge (u, v), since d(L, u) known implies d(L, v) known.
+    // - d(v, L) unknown: v cannot reach L, but t can, so v cannot reach t at all. The bound is
+    //   UNREACHABLE, and A* never queues v, so no edge out of v is ever relaxed.
+    std::uint32_t bound = 0;
+    for (int i = 0; i < landmarkCount; ++i)
+    {
+        if (targetFrom[i] != NO_DISTANCE && vertexFrom[i] != NO_DISTANCE && targetFrom[i] > vertexFrom[i])
+            bound = std::max(bound, targetFrom[i] - vertexFrom[i]);
+        if (targetTo[i] != NO_DISTANCE)
+        {
+            if (vertexTo[i] == NO_DISTANCE)
+                return ShortestPathTree::UNREACHABLE;
+            if (vertexTo[i] > targetTo[i])
+                bound = std::max(bound, vertexTo[i] - targetTo[i]);
+        }
+    }
+    return bound;
+}
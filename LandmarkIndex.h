@@ -0,0 +1,90 @@
+#ifndef LANDMARKINDEX_H
+#define LANDMARKINDEX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "CsrGraph.h"
+
+/**
+ * Landmark distance tables for A* search with the triangle inequality (ALT), for graphs with
+ * unsigned integer weights.
+ * For every landmark <i>L</i> the index stores <i>d(L, v)</i> and <i>d(v, L)</i> for every vertex,
+ * which bound a travel time from below: <i>d(v, t) >= d(L, t) - d(L, v)</i> and
+ * <i>d(v, t) >= d(v, L) - d(t, L)</i>. Landmarks are chosen by farthest-point selection, each
+ * one the vertex farthest from those already chosen, so they end up on the edges of the network.
+ * Tables are vertex-major <i>uint32</i> arrays: <i>2 * 4 * landmarkCount</i> bytes per vertex.
+ * The index is a snapshot: it does not follow later changes to the graph.
+ */
+class LandmarkIndex
+{
+private:
+    /* No route; also every entry of a landmark whose routes are too long for 32 bits */
+    static constexpr std::uint32_t NO_DISTANCE = std::numeric_limits<std::uint32_t>::max();
+
+    int landmarkCount{0};
+    std::vector<int> landmarks; /* Vertex index of each landmark */
+    std::vector<std::uint32_t> fromLandmark; /* fromLandmark[v * landmarkCount + i]: d(landmarks[i], v) */
+    std::vector<std::uint32_t> toLandmark; /* toLandmark[v * landmarkCount + i]: d(v, landmarks[i]) */
+
+    /**
+     * Chooses the landmarks and fills the distance tables from the graph's edges in CSR form.
+     * @param graph The out-edges, with their weights.
+     * @param reverse The in-edges, with their weights.
+     * @param count Number of landmarks wanted.
+     */
+    void build(const CsrGraph& graph, const CsrGraph& reverse, int count);
+
+public:
+    LandmarkIndex() = default;
+    ~LandmarkIndex() = default;
+    LandmarkIndex(const LandmarkIndex& other) = default;
+    LandmarkIndex(LandmarkIndex&& other) noexcept = default;
+    LandmarkIndex& operator=(const LandmarkIndex& other) = default;
+    LandmarkIndex& operator=(LandmarkIndex&& other) noexcept = default;
+
+    /**
+     * Chooses up to <i>count</i> landmarks of <i>graph</i> and computes their distance tables,
+     * by two runs of Dijkstra's algorithm per landmark.
+     * @tparam GraphType Provides <i>vertexCount()</i>, <i>forEachOutEdge(index, visit)</i> and
+     * <i>forEachInEdge(index, visit)</i> with unsigned integer weights.
+     * @param graph The graph to index.
+     * @param count Number of landmarks, capped at the number of vertices.
+     */
+    template <class GraphType>
+    LandmarkIndex(const GraphType& graph, int count);
+
+    /**
+     * @return The number of indexed vertices.
+     */
+    int vertexCount() const;
+
+    /**
+     * @return The vertex indexes of the landmarks, in the order they were chosen.
+     */
+    const std::vector<int>& getLandmarks() const;
+
+    /**
+     * @return The size of the distance tables, in bytes.
+     */
+    std::size_t memoryUsage() const;
+
+    /**
+     * Bounds the travel time from <i>vertex</i> to <i>target</i> from below, by the best landmark.
+     * @param vertex A valid vertex index.
+     * @param target A valid vertex index.
+     * @return A lower bound of the travel time, consistent along every edge; 0 if no landmark gives one,
+     * <i>ShortestPathTree::UNREACHABLE</i> if a landmark shows there is no route.
+     */
+    std::uint64_t lowerBound(int vertex, int target) const;
+};
+
+template <class GraphType>
+LandmarkIndex::LandmarkIndex(const GraphType& graph, const int count)
+{
+    build(CsrGraph::outEdges(graph), CsrGraph::inEdges(graph), count);
+}
+
+#endif //LANDMARKINDEX_H
@@ -0,0 +1,107 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#if __has_include(<sys/mman.h>)
+#define MAPPEDFILE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <sstream>
+#endif
+
+#if MAPPEDFILE_MMAP
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+    const int fd = open(fileName.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::invalid_argument("Error: Could not open file " + fileName);
+
+    struct stat status{};
+    if (fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+    {
+        const std::size_t size = static_cast<std::size_t>(status.st_size);
+        void* start = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (start != MAP_FAILED)
+        {
+            madvise(start, size, MADV_SEQUENTIAL); // Only a hint: read ahead, drop pages behind
+            mapped = static_cast<const char*>(start);
+            mappedSize = size;
+            close(fd);
+            return;
+        }
+    }
+
+    // Not mappable: read it whole
+    char chunk[1 << 16];
+    for (ssize_t count; (count = read(fd, chunk, sizeof chunk)) != 0;)
+    {
+        if (count < 0)
+        {
+            close(fd);
+            throw std::invalid_argument("Error: Could not read file " + fileName);
+        }
+        buffer.append(chunk, static_cast<std::size_t>(count));
+    }
+    close(fd);
+}
+
+void MappedFile::unmap() noexcept
+{
+    if (mapped)
+        munmap(const_cast<char*>(mapped), mappedSize);
+    mapped = nullptr;
+    mappedSize = 0;
+}
+
+#else
+
+MappedFile::MappedFile(const std::string& fileName)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+        throw std::invalid_argument("Error: Could not open file " + fileName);
+
+    std::ostringstream contents;
+    contents << file.rdbuf();
+    buffer = std::move(contents).str();
+}
+
+void MappedFile::unmap() noexcept
+{
+}
+
+#endif
+
+MappedFile::~MappedFile()
+{
+    unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : mapped(std::exchange(other.mapped, nullptr)), mappedSize(std::exchange(other.mappedSize, 0)),
+      buffer(std::move(other.buffer))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        unmap();
+        mapped = std::exchange(other.mapped, nullptr);
+        mappedSize = std::exchange(other.mappedSize, 0);
+        buffer = std::move(other.buffer);
+    }
+    return *this;
+}
+
+std::string_view MappedFile::contents() const
+{
+    return mapped ? std::string_view(mapped, mappedSize) : std::string_view(buffer);
+}
@@ -0,0 +1,45 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * The contents of a file, read-only and in memory for the object's lifetime.
+ * A regular file is memory-mapped, so its pages are read in by the kernel as they are touched
+ * and never copied; anything that cannot be mapped (a pipe, an empty file, a platform without
+ * <i>mmap</i>) is read into an owned buffer instead.
+ */
+class MappedFile
+{
+private:
+    const char* mapped{nullptr}; /* Start of the mapping, null if the contents are in buffer */
+    std::size_t mappedSize{0};
+    std::string buffer; /* The contents, if they could not be mapped */
+
+    /**
+     * Unmaps the file, if it is mapped.
+     */
+    void unmap() noexcept;
+
+public:
+    /**
+     * Maps or reads <i>fileName</i>.
+     * @param fileName The file to open.
+     * @throws std::invalid_argument If the file cannot be opened or read.
+     */
+    explicit MappedFile(const std::string& fileName);
+    ~MappedFile();
+    MappedFile(const MappedFile& other) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(const MappedFile& other) = delete;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    /**
+     * @return The file's bytes, valid while this object lives.
+     */
+    std::string_view contents() const;
+};
+
+#endif //MAPPEDFILE_H
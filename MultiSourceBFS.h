@@ -0,0 +1,90 @@
+#ifndef MULTISOURCEBFS_H
+#define MULTISOURCEBFS_H
+
+#include <bit>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Runs up to 64 breadth-first searches at once over the same graph (MS-BFS).
+ * Every vertex carries a 64-bit mask of the searches that have seen it, and of the ones
+ * that reach it in the current level. Expanding a vertex pushes its whole mask along each
+ * out-edge, so an edge is scanned once per level for the batch instead of once per source.
+ * The scratch buffers are kept between batches; use one instance per thread.
+ */
+class MultiSourceBFS
+{
+private:
+    std::vector<std::uint64_t> seen; /* seen[v]: searches that reached v */
+    std::vector<std::uint64_t> visit; /* visit[v]: searches expanding v in the current level */
+    std::vector<std::uint64_t> visitNext; /* visitNext[v]: searches that reached v in this level */
+    std::vector<int> frontier; /* Vertices with a nonzero visit mask */
+    std::vector<int> nextFrontier; /* Vertices with a nonzero visitNext mask */
+
+public:
+    static constexpr int BATCH_SIZE = 64;
+
+    /**
+     * Searches from <i>count</i> sources at once.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>.
+     * @param graph The graph to search.
+     * @param sources Vertex indexes to search from.
+     * @param count Number of sources, at most <i>BATCH_SIZE</i>.
+     * @param reached Callable taking <i>(int slot, int vertex)</i>, called once for every vertex
+     * search <i>slot</i> reaches other than its source, level by level.
+     */
+    template <class GraphType, class Visitor>
+    void run(const GraphType& graph, const int* sources, int count, Visitor&& reached);
+};
+
+template <class GraphType, class Visitor>
+void MultiSourceBFS::run(const GraphType& graph, const int* sources, const int count, Visitor&& reached)
+{
+    const int size = graph.vertexCount();
+    seen.assign(size, 0);
+    visit.assign(size, 0);
+    visitNext.assign(size, 0);
+    frontier.clear();
+
+    for (int slot = 0; slot < count; ++slot)
+    {
+        const int source = sources[slot];
+        if (visit[source] == 0)
+            frontier.push_back(source);
+        seen[source] |= std::uint64_t{1} << slot;
+        visit[source] |= std::uint64_t{1} << slot;
+    }
+
+    while (!frontier.empty())
+    {
+        nextFrontier.clear();
+
+        for (const int v : frontier)
+        {
+            const std::uint64_t searches = visit[v];
+            graph.forEachOutEdge(v, [&](const int neighbor, const auto&)
+            {
+                const std::uint64_t discovered = searches & ~seen[neighbor];
+                if (discovered == 0)
+                    return;
+
+                if (visitNext[neighbor] == 0)
+                    nextFrontier.push_back(neighbor);
+                visitNext[neighbor] |= discovered;
+                seen[neighbor] |= discovered;
+
+                for (std::uint64_t bits = discovered; bits != 0; bits &= bits - 1)
+                    reached(std::countr_zero(bits), neighbor);
+            });
+        }
+
+        for (const int v : frontier)
+            visit[v] = 0;
+        for (const int v : nextFrontier)
+            std::swap(visit[v], visitNext[v]);
+        std::swap(frontier, nextFrontier);
+    }
+}
+
+#endif //MULTISOURCEBFS_H
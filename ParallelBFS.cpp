@@ -0,0 +1,26 @@
+#include "ParallelBFS.h"
+
+void ParallelBFS::reset(const int vertexCount, const unsigned int workers)
+{
+    const std::size_t words = (static_cast<std::size_t>(vertexCount) + 63) / 64;
+    if (visitedWords < words)
+    {
+        visited.reset(new std::atomic<std::uint64_t>[words]);
+        visitedWords = words;
+    }
+    for (std::size_t w = 0; w < words; ++w)
+        visited[w].store(0, std::memory_order_relaxed);
+
+    frontier.clear();
+    frontier.reserve(vertexCount);
+    if (next.size() < workers)
+        next.resize(workers);
+    for (std::vector<int>& claimed : next)
+        claimed.clear();
+}
+
+ParallelBFS& ParallelBFS::local()
+{
+    thread_local ParallelBFS search;
+    return search;
+}
@@ -0,0 +1,136 @@
+#ifndef PARALLELBFS_H
+#define PARALLELBFS_H
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+/**
+ * Level-synchronous breadth-first search on several threads, for very large graphs.
+ * Each level's frontier is split into chunks that the threads claim from a shared counter.
+ * A thread claims a newly reached vertex by an atomic test-and-set on a visited bitmap, so
+ * every vertex is claimed exactly once, and keeps its claims in its own next-frontier buffer.
+ * At the end of a level the buffers are concatenated into the next frontier.
+ * Vertices come out level by level, but their order within a level depends on thread timing.
+ * The bitmap and buffers are kept between queries, so repeated queries on one graph do not
+ * allocate; use one instance per thread, e.g. <i>local()</i>. The helper threads are started
+ * per query, which costs far less than one level of a graph large enough to need them.
+ */
+class ParallelBFS
+{
+private:
+    static constexpr std::size_t CHUNK_SIZE = 256; /* Frontier vertices claimed at a time */
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> visited; /* One bit per vertex, set once claimed */
+    std::size_t visitedWords{0}; /* Allocated length of visited, only grows */
+    std::vector<int> frontier; /* The level being expanded */
+    std::vector<std::vector<int>> next; /* Per-thread next-frontier buffers */
+
+    /**
+     * Clears the bitmap and buffers for a search on <i>workers</i> threads. The frontier is
+     * reserved to <i>vertexCount</i>, as every vertex joins it at most once.
+     */
+    void reset(int vertexCount, unsigned int workers);
+
+public:
+    ParallelBFS() = default;
+    ~ParallelBFS() = default;
+    ParallelBFS(const ParallelBFS& other) = delete;
+    ParallelBFS(ParallelBFS&& other) noexcept = default;
+    ParallelBFS& operator=(const ParallelBFS& other) = delete;
+    ParallelBFS& operator=(ParallelBFS&& other) noexcept = default;
+
+    /**
+     * Searches from <i>source</i> on <i>threadCount</i> threads, the calling thread included.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>,
+     * safe to call concurrently.
+     * @param graph The graph to search.
+     * @param source A valid vertex index.
+     * @param threadCount Number of threads to use, at least 1.
+     * @param order Output parameter, cleared first: the reached vertices, <i>source</i> first.
+     */
+    template <class GraphType>
+    void run(const GraphType& graph, int source, unsigned int threadCount, std::vector<int>& order);
+
+    /**
+     * @return The calling thread's instance.
+     */
+    static ParallelBFS& local();
+};
+
+template <class GraphType>
+void ParallelBFS::run(const GraphType& graph, const int source, const unsigned int threadCount, std::vector<int>& order)
+{
+    const unsigned int workers = std::max(1u, threadCount);
+    reset(graph.vertexCount(), workers);
+
+    // Test-and-set: true for exactly one caller per vertex
+    const auto claim = [&](const int v)
+    {
+        const std::uint64_t bit = std::uint64_t{1} << (v % 64);
+        std::atomic<std::uint64_t>& word = visited[v / 64];
+        return (word.load(std::memory_order_relaxed) & bit) == 0 &&
+               (word.fetch_or(bit, std::memory_order_relaxed) & bit) == 0;
+    };
+
+    // Reserved up front like the frontier, so the completion step below cannot allocate
+    order.clear();
+    order.reserve(graph.vertexCount());
+    order.push_back(source);
+    frontier.push_back(source);
+    claim(source);
+
+    std::atomic<std::size_t> nextChunk{0};
+    bool done = false;
+
+    // Runs on one thread once all have finished the level
+    const auto endLevel = [&]() noexcept
+    {
+        frontier.clear();
+        for (std::vector<int>& claimed : next)
+        {
+            frontier.insert(frontier.end(), claimed.begin(), claimed.end());
+            claimed.clear();
+        }
+        order.insert(order.end(), frontier.begin(), frontier.end());
+        nextChunk.store(0, std::memory_order_relaxed);
+        done = frontier.empty();
+    };
+    std::barrier levelEnd(static_cast<std::ptrdiff_t>(workers), endLevel);
+
+    const auto worker = [&](const unsigned int id)
+    {
+        std::vector<int>& claimed = next[id];
+        while (!done)
+        {
+            for (std::size_t first = nextChunk.fetch_add(CHUNK_SIZE); first < frontier.size();
+                 first = nextChunk.fetch_add(CHUNK_SIZE))
+            {
+                const std::size_t last = std::min(first + CHUNK_SIZE, frontier.size());
+                for (std::size_t i = first; i < last; ++i)
+                {
+                    graph.forEachOutEdge(frontier[i], [&](const int neighbor, const auto&)
+                    {
+                        if (claim(neighbor))
+                            claimed.push_back(neighbor);
+                    });
+                }
+            }
+            levelEnd.arrive_and_wait();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 1; t < workers; ++t)
+        threads.emplace_back(worker, t);
+    worker(0);
+    for (auto& t : threads)
+        t.join();
+}
+
+#endif //PARALLELBFS_H
@@ -1,7 +1,17 @@
 #include "Parser.h"
-#include <fstream>
 #include <iostream>
+#include <atomic>
 #include <cctype>
+#include <charconv>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <thread>
+#include <unordered_map>
+
+#include "GraphBuilder.h"
+#include "MappedFile.h"
+#include "RecordScanner.h"
 
 bool ichar_equals(char a, char b)
 {
@@ -9,7 +19,7 @@ bool ichar_equals(char a, char b)
             tolower(static_cast<unsigned char>(b));
 }
 
-bool iequals(const string &s1, const string &s2)
+bool iequals(const string_view s1, const string_view s2)
 {
     return s1.size() == s2.size() &&  std::equal(s1.begin(), s1.end(), s2.begin(), ichar_equals);
 }
@@ -18,7 +28,7 @@ Parser::Parser(int argc, char **argv)
 {
     if (argc < 2)
     {
-        cerr << "Usage: " << argv[0] << " <infile1> <infile2> ... [-o] <outfile>" << endl;
+        printUsage(argv[0]);
         throw invalid_argument("Wrong number of input files");
     }
 
@@ -31,24 +41,105 @@ Parser::Parser(int argc, char **argv)
             parsedArgs.hasOutputFlag = true;
             parsedArgs.outputFile = argv[++i];
         }
+        else if (arg == "-s" || arg == "-w")
+        {
+            if (i + 1 == argc)
+                usageError(argv[0], "Error: Missing file name after " + arg);
+            (arg == "-s" ? parsedArgs.loadSnapshotFile : parsedArgs.saveSnapshotFile) = argv[++i];
+        }
+        else if (arg == "-t")
+        {
+            if (i + 1 == argc)
+                usageError(argv[0], "Error: Missing thread count after -t");
+            const string_view count = argv[++i];
+            const auto [end, error] = from_chars(count.data(), count.data() + count.size(), parsedArgs.threadCount);
+            if (error != errc() || end != count.data() + count.size() ||
+                parsedArgs.threadCount < 1 || parsedArgs.threadCount > MAX_THREADS)
+                usageError(argv[0], "Error: The thread count must be between 1 and " + to_string(MAX_THREADS));
+        }
         else if (i == argc - 1 && !parsedArgs.hasOutputFlag)
             parsedArgs.outputFile = arg;
         else
             parsedArgs.inputFiles.push_back(arg);
     }
-    parseFiles();
+
+    if (parsedArgs.loadSnapshotFile.empty() == parsedArgs.inputFiles.empty())
+        usageError(argv[0], "Error: Give either input files or a snapshot");
+
+    try
+    {
+        if (!parsedArgs.loadSnapshotFile.empty())
+            network = CompactGraph<string, unsigned int>::loadSnapshot(parsedArgs.loadSnapshotFile);
+        else
+            parseFiles();
+
+        if (!parsedArgs.saveSnapshotFile.empty())
+        {
+            if (!network)
+                network = graph.freeze();
+            network->saveSnapshot(parsedArgs.saveSnapshotFile);
+        }
+    }
+    catch (const invalid_argument& e)
+    {
+        cerr << e.what() << endl;
+        exit(EXIT_FAILURE);
+    }
+}
+
+void Parser::printUsage(const string_view program)
+{
+    cerr << "Usage: " << program << " <infile1> <infile2> ... [-w <snapshot>] [-t <threads>] [-o] <outfile>" << endl;
+    cerr << "       " << program << " -s <snapshot> [-w <snapshot>] [-t <threads>] [-o] <outfile>" << endl;
+    cerr << "  -t  Threads for each connection search (default 1). With more than one, stations" << endl;
+    cerr << "      still come out by hop distance, but their order within one distance varies." << endl;
 }
 
-Graph<string, unsigned int> Parser::getGraph() const
+void Parser::usageError(const string_view program, const string& message)
+{
+    cerr << message << endl;
+    printUsage(program);
+    exit(EXIT_FAILURE);
+}
+
+unsigned int Parser::getThreadCount() const
+{
+    return parsedArgs.threadCount;
+}
+
+const Graph<string, unsigned int>& Parser::getGraph() const &
 {
     return graph;
 }
 
-bool Parser::parseAndValidateLine(const string& line, string& source, string& target, unsigned int& hopTime)
+Graph<string, unsigned int> Parser::getGraph() &&
 {
-    stringstream ss(line);
+    return move(graph);
+}
 
-    if (!(getline(ss, source, '\t') && getline(ss, target, '\t') && ss >> hopTime))
+CompactGraph<string, unsigned int> Parser::getNetwork() &&
+{
+    return network ? move(*network) : graph.freeze();
+}
+
+bool Parser::parseAndValidateLine(const string_view line, string_view& source, string_view& target, unsigned int& hopTime)
+{
+    const size_t sourceEnd = line.find('\t');
+    if (sourceEnd == string_view::npos)
+        return false;
+    const size_t targetEnd = line.find('\t', sourceEnd + 1);
+    if (targetEnd == string_view::npos)
+        return false;
+
+    source = line.substr(0, sourceEnd);
+    target = line.substr(sourceEnd + 1, targetEnd - sourceEnd - 1);
+    return validateFields(source, target, line.substr(targetEnd + 1), hopTime);
+}
+
+bool Parser::validateFields(const string_view source, const string_view target, const string_view hopField,
+                            unsigned int& hopTime)
+{
+    if (!parseHopTime(hopField, hopTime))
         return false;
 
     if (source.length() > MAX_CITY_NAME)
@@ -60,61 +151,182 @@ bool Parser::parseAndValidateLine(const string& line, string& source, string& ta
     if (iequals(source, "exit") || iequals(target, "exit"))
         return false;
 
-    if (source.find(' ') != string::npos or target.find(' ') != string::npos)
+    if (source.find(' ') != string_view::npos or target.find(' ') != string_view::npos)
         return false;
 
     return true;
 }
 
-void Parser::parseSingleFile(Graph<string, unsigned int>& graph, const string &fileName)
+bool Parser::parseHopTime(const string_view field, unsigned int& hopTime)
 {
-    ifstream file(fileName);
-    if (!file)
-        throw invalid_argument("Error: Could not open file " + fileName);
+    if (RecordScanner::parseShortNumber(field, hopTime))
+        return true;
 
-    string line;
-    while (getline(file, line))
+    size_t i = 0;
+    while (i < field.size() && (field[i] == ' ' || (field[i] >= '\t' && field[i] <= '\r')))
+        ++i;
+
+    const bool negative = i < field.size() && field[i] == '-';
+    if (i < field.size() && (field[i] == '-' || field[i] == '+'))
+        ++i;
+
+    const size_t digitsStart = i;
+    unsigned long long magnitude = 0;
+    bool overflow = false;
+    for (; i < field.size() && field[i] >= '0' && field[i] <= '9'; ++i)
     {
-        string source, target;
-        unsigned int hopTime;
+        magnitude = magnitude * 10 + static_cast<unsigned int>(field[i] - '0');
+        overflow |= magnitude > numeric_limits<unsigned int>::max();
+        if (overflow)
+            magnitude = 0; // Keep consuming digits without wrapping back into range
+    }
 
-        if (!parseAndValidateLine(line, source, target, hopTime))
-        {
-            throw invalid_argument("Malformed line in file " + fileName + ": " + line);
-        }
+    if (i == digitsStart || overflow)
+        return false;
 
-        graph.addVertex(source);
-        graph.addVertex(target);
+    hopTime = negative ? 0u - static_cast<unsigned int>(magnitude) : static_cast<unsigned int>(magnitude);
+    return true;
+}
 
-        try
+Parser::ParsedFile Parser::parseSingleFile(const string &fileName)
+{
+    const MappedFile file(fileName);
+    const string_view contents = file.contents();
+
+    ParsedFile parsed;
+    unordered_map<string_view, int> ids; /* Names point into the mapped file */
+
+    const auto intern = [&](const string_view name)
+    {
+        const auto [it, added] = ids.try_emplace(name, static_cast<int>(parsed.names.size()));
+        if (added)
+            parsed.names.emplace_back(name);
+        return it->second;
+    };
+
+    const auto addLine = [&](const string_view sourceName, const string_view targetName, const unsigned int hopTime)
+    {
+        const int source = intern(sourceName);
+        const int target = intern(targetName);
+        parsed.edges.push_back({source, target, hopTime});
+    };
+
+    const auto malformed = [&](const string_view line)
+    {
+        return invalid_argument("Malformed line in file " + fileName + ": " + string(line));
+    };
+
+    const RecordScanner scanner;
+    vector<uint32_t> delimiters(min(contents.size(), SCAN_BLOCK_SIZE));
+
+    for (size_t blockStart = 0; blockStart < contents.size();)
+    {
+        // A block ends after its last newline, so no line straddles two blocks
+        size_t blockEnd = contents.size();
+        if (contents.size() - blockStart > SCAN_BLOCK_SIZE)
+            blockEnd = contents.rfind('\n', blockStart + SCAN_BLOCK_SIZE - 1) + 1;
+
+        if (blockEnd <= blockStart)
         {
-            graph.addEdge(source, target, hopTime);
+            // A line longer than a block: split it on its own
+            const size_t lineEnd = min(contents.find('\n', blockStart), contents.size());
+            const string_view line = contents.substr(blockStart, lineEnd - blockStart);
+            string_view sourceName, targetName;
+            unsigned int hopTime;
+            if (!parseAndValidateLine(line, sourceName, targetName, hopTime))
+                throw malformed(line);
+            addLine(sourceName, targetName, hopTime);
+            blockStart = lineEnd + 1;
+            continue;
         }
-        catch (const EdgeAlreadyExistsException<string>&)
+
+        const string_view block = contents.substr(blockStart, blockEnd - blockStart);
+        const size_t count = scanner.findDelimiters(block, delimiters.data());
+
+        size_t next = 0; /* The first delimiter not consumed yet */
+        for (size_t lineStart = 0; lineStart < block.size();)
         {
-            graph.updateWeight(source, target, min(hopTime, graph.getWeight(source, target)));
+            size_t tabs[2];
+            size_t tabCount = 0;
+            for (; next < count && block[delimiters[next]] == '\t'; ++next)
+                if (tabCount < 2)
+                    tabs[tabCount++] = delimiters[next];
+            const size_t lineEnd = next < count ? delimiters[next++] : block.size();
+            const string_view line = block.substr(lineStart, lineEnd - lineStart);
+            if (tabCount < 2)
+                throw malformed(line);
+
+            const string_view sourceName = block.substr(lineStart, tabs[0] - lineStart);
+            const string_view targetName = block.substr(tabs[0] + 1, tabs[1] - tabs[0] - 1);
+            unsigned int hopTime;
+            if (!validateFields(sourceName, targetName, block.substr(tabs[1] + 1, lineEnd - tabs[1] - 1), hopTime))
+                throw malformed(line);
+            addLine(sourceName, targetName, hopTime);
+            lineStart = lineEnd + 1;
         }
+
+        blockStart = blockEnd;
     }
 
-    file.close();
+    return parsed;
 }
 
 void Parser::parseFiles()
 {
-    Graph<string, unsigned int> result;
+    const vector<string>& fileNames = parsedArgs.inputFiles;
+    vector<ParsedFile> parsed(fileNames.size());
+    vector<exception_ptr> errors(fileNames.size());
 
-    for (const auto& fileName : parsedArgs.inputFiles)
+    // Every file has its own slots, so workers never write the same one
+    atomic<size_t> nextFile{0};
+    const auto worker = [&]()
+    {
+        for (size_t i = nextFile++; i < fileNames.size(); i = nextFile++)
+        {
+            try
+            {
+                parsed[i] = parseSingleFile(fileNames[i]);
+            }
+            catch (...)
+            {
+                errors[i] = current_exception();
+            }
+        }
+    };
+
+    const size_t threadCount = min<size_t>(fileNames.size(), max(1u, thread::hardware_concurrency()));
+    vector<thread> threads;
+    for (size_t t = 1; t < threadCount; ++t)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& t : threads)
+        t.join();
+
+    GraphBuilder<string, unsigned int> builder;
+    vector<int> indexes; /* Graph index of each name of the current file */
+
+    for (size_t i = 0; i < fileNames.size(); ++i)
     {
         try
         {
-            parseSingleFile(result, fileName);
+            if (errors[i])
+                rethrow_exception(errors[i]);
         }
         catch (const exception& e)
         {
             cerr << e.what() << endl;
             exit(EXIT_FAILURE);
         }
+
+        indexes.clear();
+        for (const string& name : parsed[i].names)
+            indexes.push_back(builder.addVertex(name));
+
+        builder.reserveEdges(parsed[i].edges.size());
+        for (const ParsedEdge& edge : parsed[i].edges)
+            builder.addEdge(indexes[edge.source], indexes[edge.target], edge.hopTime);
+        parsed[i] = ParsedFile(); // Release the file's copy of its names and edges
     }
 
-    graph = result;
-}
\ No newline at end of file
+    graph = builder.build();
+}
@@ -1,57 +1,147 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
+#include "CompactGraph.h"
 #include "Graph.h"
 
-bool iequals(const string &s1, const string &s2);
+bool iequals(string_view s1, string_view s2);
 
 using namespace std;
 /**
  * Represents the arguments after parsing.
  * Has input files as a vector of filenames.
- * Holds information about output file
+ * Holds information about output file, and about the snapshot to load instead of the input files
+ * (<i>-s</i>) or to save the parsed network to (<i>-w</i>), and the number of threads for
+ * connection searches (<i>-t</i>).
  */
 struct ParsedArgs {
     vector<string> inputFiles;
     string outputFile;
     bool hasOutputFlag = false;
+    string loadSnapshotFile;
+    string saveSnapshotFile;
+    unsigned int threadCount = 1;
 };
 
 class Parser {
 public:
     static constexpr unsigned int MAX_CITY_NAME = 16;
+    static constexpr unsigned int MAX_THREADS = 256;
     Parser(int argc, char** argv);
 
-    Graph<string, unsigned int> getGraph() const;
+    /**
+     * @return The number of threads for connection searches given by <i>-t</i>, 1 by default.
+     */
+    unsigned int getThreadCount() const;
+
+    /**
+     * @return The parsed network; empty if it was loaded from a snapshot.
+     */
+    const Graph<string, unsigned int>& getGraph() const &;
+
+    /**
+     * Moves the parsed network out of a parser that is going away, without copying it.
+     * @return The parsed network.
+     */
+    Graph<string, unsigned int> getGraph() &&;
+
+    /**
+     * Moves the network out of a parser that is going away, in the read-only form queries use:
+     * the loaded snapshot, or the parsed graph frozen.
+     * @return The network.
+     */
+    CompactGraph<string, unsigned int> getNetwork() &&;
 
 private:
+    /**
+     * An edge of one input file, by indexes into the file's station names.
+     */
+    struct ParsedEdge {
+        int source;
+        int target;
+        unsigned int hopTime;
+    };
+
+    /**
+     * The network of one input file, before it is merged with the others.
+     */
+    struct ParsedFile {
+        vector<string> names; /* Station names, in order of first appearance */
+        vector<ParsedEdge> edges; /* Every line's edge, in file order, duplicates included */
+    };
+
+    static constexpr size_t SCAN_BLOCK_SIZE = 1 << 20; /* Bytes handed to the RecordScanner at a time */
+
     ParsedArgs parsedArgs;
     Graph<string, unsigned int> graph;
+    optional<CompactGraph<string, unsigned int>> network; /* Set when loaded from or saved to a snapshot */
+
+    /**
+     * Prints the command-line usage to <i>cerr</i>.
+     * @param program The program's name, <i>argv[0]</i>.
+     */
+    static void printUsage(string_view program);
+
+    /**
+     * Reports a command-line error with the usage, and exits.
+     * @param program The program's name, <i>argv[0]</i>.
+     * @param message What is wrong with the arguments.
+     */
+    [[noreturn]] static void usageError(string_view program, const string& message);
 
     /**
-     * Parses a single line from an input file.
-     * @param line The input line to parse.
-     * @param source Output parameter for the source node.
-     * @param target Output parameter for the target node.
+     * Parses a single line from an input file: a source, a target and a hop time, separated by tabs.
+     * @param line The input line to parse, without its newline.
+     * @param source Output parameter for the source node; points into <i>line</i>.
+     * @param target Output parameter for the target node; points into <i>line</i>.
      * @param hopTime Output parameter for the hop time.
      * @return True if parsing was successful, false otherwise.
      */
-    static bool parseAndValidateLine(const string& line, string& source, string& target, unsigned int& hopTime);
+    static bool parseAndValidateLine(string_view line, string_view& source, string_view& target, unsigned int& hopTime);
+
+    /**
+     * Validates the fields of a line, however they were split: names of at most <i>MAX_CITY_NAME</i>
+     * characters, without spaces and other than "exit", and a hop time.
+     * @param source The source node.
+     * @param target The target node.
+     * @param hopField The text after the second tab.
+     * @param hopTime Output parameter for the hop time.
+     * @return True if the fields are valid, false otherwise.
+     */
+    static bool validateFields(string_view source, string_view target, string_view hopField, unsigned int& hopTime);
+
+    /**
+     * Parses the hop time field the way <i>operator>></i> reads an <i>unsigned int</i> in the classic locale:
+     * leading whitespace is skipped, a sign is allowed (a negative value wraps around), and anything
+     * after the digits is ignored. A field of a few digits takes <i>RecordScanner::parseShortNumber</i>.
+     * @param field The text after the second tab.
+     * @param hopTime Output parameter for the hop time.
+     * @return True if the field starts with a number that fits, false otherwise.
+     */
+    static bool parseHopTime(string_view field, unsigned int& hopTime);
 
     /**
-     * Parses a file and adds it to <i>graph</i>
-     * @param graph Graph to add parse the files into
+     * Parses a file into its own station names and edges, without touching any graph,
+     * so that files can be parsed concurrently.
+     * The file is memory-mapped and split in place: blocks of whole lines go through a <i>RecordScanner</i>,
+     * whose delimiters give every line's fields for <i>validateFields</i>, so no line is copied.
      * @param fileName File to be parsed
+     * @return The file's stations and edges.
+     * @throws std::invalid_argument If the file cannot be read or has a malformed line.
      */
-    static void parseSingleFile(Graph<string, unsigned int>& graph, const string &fileName);
+    static ParsedFile parseSingleFile(const string &fileName);
 
     /**
-     * Parses the input files and returns a Graph<string, unsigned int>
-     * representing the network.
-     * @return Graph<string, unsigned int> with the parsed data.
+     * Parses the input files, each on its own thread up to the number of cores, and merges them
+     * through a <i>GraphBuilder</i> in file order: vertices get their indexes in the order a sequential
+     * load first meets them, and duplicate edges fold in line order (the minimum hop time wins, a hop
+     * time of 0 removes the edge), so the result does not depend on thread timing.
+     * Exits on the first file, in order, that fails to parse.
      */
     void parseFiles();
 };
@@ -0,0 +1,63 @@
+#include "RadixHeap.h"
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+
+int RadixHeap::bucketFor(const std::uint64_t key) const
+{
+    return key == last ? 0 : 64 - std::countl_zero(key ^ last);
+}
+
+void RadixHeap::push(const std::uint64_t key, const int vertex)
+{
+    buckets[bucketFor(key)].emplace_back(key, vertex);
+    ++count;
+}
+
+std::uint64_t RadixHeap::topKey()
+{
+    if (isEmpty())
+        throw std::out_of_range("RadixHeap is empty");
+
+    if (buckets[0].empty())
+    {
+        // Move to the first non-empty bucket's minimum; its entries all land in lower buckets
+        int i = 1;
+        while (buckets[i].empty())
+            ++i;
+
+        last = buckets[i].front().first;
+        for (const auto& entry : buckets[i])
+            last = std::min(last, entry.first);
+
+        for (const auto& entry : buckets[i])
+            buckets[bucketFor(entry.first)].push_back(entry);
+        buckets[i].clear();
+    }
+
+    return last;
+}
+
+std::pair<std::uint64_t, int> RadixHeap::pop()
+{
+    topKey();
+
+    const auto entry = buckets[0].back();
+    buckets[0].pop_back();
+    --count;
+    return entry;
+}
+
+bool RadixHeap::isEmpty() const
+{
+    return count == 0;
+}
+
+void RadixHeap::clear()
+{
+    for (auto& bucket : buckets)
+        bucket.clear();
+    last = 0;
+    count = 0;
+}
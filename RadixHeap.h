@@ -0,0 +1,63 @@
+#ifndef RADIXHEAP_H
+#define RADIXHEAP_H
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+/**
+ * Monotone priority queue of vertexes keyed by travel time, for Dijkstra-style searches.
+ * A bucket queue with logarithmic bucket widths (a radix heap): an entry lives in the bucket of the
+ * highest bit in which its key differs from the last popped key. Pushes are O(1) and every entry
+ * moves down at most 64 times, whatever the largest key, where Dial's circular buckets would need
+ * one bucket per possible edge weight.
+ * Keys pushed must not be smaller than the last popped key.
+ */
+class RadixHeap
+{
+private:
+    static constexpr int BUCKET_COUNT = 65;
+
+    std::vector<std::pair<std::uint64_t, int>> buckets[BUCKET_COUNT]; /* (key, vertex) entries */
+    std::uint64_t last{0}; /* The last popped key */
+    std::size_t count{0};
+
+    int bucketFor(std::uint64_t key) const;
+
+public:
+    RadixHeap() = default;
+    ~RadixHeap() = default;
+    RadixHeap(const RadixHeap& other) = default;
+    RadixHeap(RadixHeap&& other) noexcept = default;
+    RadixHeap& operator=(const RadixHeap& other) = default;
+    RadixHeap& operator=(RadixHeap&& other) noexcept = default;
+
+    /**
+     * @param key The priority, at least the last popped key.
+     * @param vertex The vertex index.
+     */
+    void push(std::uint64_t key, int vertex);
+
+    /**
+     * Removes an entry with the smallest key.
+     * @return The entry's key and vertex.
+     * @throws std::out_of_range If the queue is empty.
+     */
+    std::pair<std::uint64_t, int> pop();
+
+    /**
+     * @return The smallest key, without removing it.
+     * @throws std::out_of_range If the queue is empty.
+     */
+    std::uint64_t topKey();
+
+    bool isEmpty() const;
+
+    /**
+     * Removes every entry and resets the last popped key to 0, keeping the buckets' capacity.
+     */
+    void clear();
+};
+
+#endif //RADIXHEAP_H
@@ -0,0 +1,84 @@
+#include "ReachabilityIndex.h"
+
+#include <algorithm>
+
+void ReachabilityIndex::build(const CsrGraph& graph)
+{
+    const std::vector<int>& offsets = graph.offsets;
+    const std::vector<int>& adjacency = graph.adjacency;
+    sccs = StronglyConnectedComponents(offsets, adjacency);
+    const int componentCount = sccs.componentCount();
+
+    // Successors always have lower ids, so their reachable sets are complete
+    // by the time a component unions them into its own.
+    std::vector<int> stamps(componentCount, -1);
+    std::vector<int> current;
+    reachOffsets.assign(1, 0);
+    reach.clear();
+
+    for (int c = 0; c < componentCount; ++c)
+    {
+        current.clear();
+        current.push_back(c);
+        stamps[c] = c;
+
+        sccs.forEachMember(c, [&](const int v)
+        {
+            for (int e = offsets[v]; e < offsets[v + 1]; ++e)
+            {
+                const int successor = sccs.componentOf(adjacency[e]);
+                if (stamps[successor] == c)
+                    continue;
+
+                for (int r = reachOffsets[successor]; r < reachOffsets[successor + 1]; ++r)
+                {
+                    if (stamps[reach[r]] != c)
+                    {
+                        stamps[reach[r]] = c;
+                        current.push_back(reach[r]);
+                    }
+                }
+            }
+        });
+
+        std::sort(current.begin(), current.end());
+        reach.insert(reach.end(), current.begin(), current.end());
+        reachOffsets.push_back(static_cast<int>(reach.size()));
+    }
+}
+
+int ReachabilityIndex::vertexCount() const
+{
+    return sccs.vertexCount();
+}
+
+const StronglyConnectedComponents& ReachabilityIndex::getComponents() const
+{
+    return sccs;
+}
+
+bool ReachabilityIndex::isReachable(const int from, const int to) const
+{
+    if (from == to)
+        return false;
+    const int component = sccs.componentOf(from);
+    const auto first = reach.begin() + reachOffsets[component];
+    const auto last = reach.begin() + reachOffsets[component + 1];
+    return std::binary_search(first, last, sccs.componentOf(to));
+}
+
+std::vector<int> ReachabilityIndex::reachableFrom(const int vertex) const
+{
+    const int component = sccs.componentOf(vertex);
+
+    std::vector<int> result;
+    for (int r = reachOffsets[component]; r < reachOffsets[component + 1]; ++r)
+    {
+        sccs.forEachMember(reach[r], [&](const int member)
+        {
+            if (member != vertex)
+                result.push_back(member);
+        });
+    }
+    return result;
+}
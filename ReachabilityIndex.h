@@ -0,0 +1,78 @@
+#ifndef REACHABILITYINDEX_H
+#define REACHABILITYINDEX_H
+
+#include <vector>
+
+#include "CsrGraph.h"
+#include "StronglyConnectedComponents.h"
+
+/**
+ * Precomputed reachability over the strongly connected components (SCCs) of a graph.
+ * Vertices of one SCC reach exactly the same vertices, so the graph is condensed into a DAG
+ * of components, and every component stores the sorted list of components it reaches.
+ * A reachability query then expands those lists instead of traversing the graph.
+ * The index is a snapshot: it does not follow later changes to the graph.
+ */
+class ReachabilityIndex
+{
+private:
+    StronglyConnectedComponents sccs;
+    std::vector<int> reachOffsets; /* Start of each component's reachable set in reach, plus a trailing end offset */
+    std::vector<int> reach; /* Components reachable from each component (itself included), ascending */
+
+    /**
+     * Builds the index from the graph's out-edges in CSR form.
+     */
+    void build(const CsrGraph& graph);
+
+public:
+    ReachabilityIndex() = default;
+    ~ReachabilityIndex() = default;
+    ReachabilityIndex(const ReachabilityIndex& other) = default;
+    ReachabilityIndex(ReachabilityIndex&& other) noexcept = default;
+    ReachabilityIndex& operator=(const ReachabilityIndex& other) = default;
+    ReachabilityIndex& operator=(ReachabilityIndex&& other) noexcept = default;
+
+    /**
+     * Builds the index of <i>graph</i>, in O(V + E) plus the size of the component reachability sets.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>.
+     * @param graph The graph to index.
+     */
+    template <class GraphType>
+    explicit ReachabilityIndex(const GraphType& graph);
+
+    /**
+     * @return The number of indexed vertices.
+     */
+    int vertexCount() const;
+
+    /**
+     * @return The strongly connected components of the graph.
+     */
+    const StronglyConnectedComponents& getComponents() const;
+
+    /**
+     * Checks whether <i>to</i> is among the vertices a BFS from <i>from</i> reaches,
+     * <i>from</i> itself excluded. Binary search over the component's reachable set.
+     * @param from A valid vertex index.
+     * @param to A valid vertex index.
+     * @return <i>true</i> if <i>from != to</i> and a path leads from <i>from</i> to <i>to</i>.
+     */
+    bool isReachable(int from, int to) const;
+
+    /**
+     * Retrieves every vertex reachable from <i>vertex</i> using one or more edges,
+     * other than <i>vertex</i> itself: the same set as a BFS from <i>vertex</i>.
+     * @param vertex A valid vertex index.
+     * @return The reachable vertex indexes, grouped by component.
+     */
+    std::vector<int> reachableFrom(int vertex) const;
+};
+
+template <class GraphType>
+ReachabilityIndex::ReachabilityIndex(const GraphType& graph)
+{
+    build(CsrGraph::outEdges<false>(graph));
+}
+
+#endif //REACHABILITYINDEX_H
@@ -0,0 +1,152 @@
+#include "RecordScanner.h"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define RECORDSCANNER_X86 1
+#include <immintrin.h>
+#endif
+
+namespace
+{
+    /**
+     * Appends <i>base + i</i> for every set bit <i>i</i> of <i>mask</i>, lowest first.
+     */
+    template <class Mask>
+    std::size_t appendOffsets(Mask mask, const std::uint32_t base, std::uint32_t* out)
+    {
+        std::size_t count = 0;
+        for (; mask != 0; mask &= mask - 1)
+            out[count++] = base + static_cast<std::uint32_t>(std::countr_zero(mask));
+        return count;
+    }
+
+    std::size_t findScalar(const char* text, const std::size_t begin, const std::size_t end, std::uint32_t* out)
+    {
+        std::size_t count = 0;
+        for (std::size_t i = begin; i < end; ++i)
+            if (text[i] == '\t' || text[i] == '\n')
+                out[count++] = static_cast<std::uint32_t>(i);
+        return count;
+    }
+
+#ifdef RECORDSCANNER_X86
+    __attribute__((target("sse2")))
+    std::size_t findSse2(const char* text, const std::size_t size, std::uint32_t* out)
+    {
+        const __m128i tab = _mm_set1_epi8('\t');
+        const __m128i newline = _mm_set1_epi8('\n');
+        std::size_t count = 0;
+        std::size_t i = 0;
+        for (; i + 16 <= size; i += 16)
+        {
+            const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+            const __m128i found = _mm_or_si128(_mm_cmpeq_epi8(bytes, tab), _mm_cmpeq_epi8(bytes, newline));
+            const auto mask = static_cast<std::uint32_t>(_mm_movemask_epi8(found));
+            count += appendOffsets(mask, static_cast<std::uint32_t>(i), out + count);
+        }
+        return count + findScalar(text, i, size, out + count);
+    }
+
+    __attribute__((target("avx2")))
+    std::size_t findAvx2(const char* text, const std::size_t size, std::uint32_t* out)
+    {
+        const __m256i tab = _mm256_set1_epi8('\t');
+        const __m256i newline = _mm256_set1_epi8('\n');
+        std::size_t count = 0;
+        std::size_t i = 0;
+        for (; i + 32 <= size; i += 32)
+        {
+            const __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text + i));
+            const __m256i found = _mm256_or_si256(_mm256_cmpeq_epi8(bytes, tab), _mm256_cmpeq_epi8(bytes, newline));
+            const auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(found));
+            count += appendOffsets(mask, static_cast<std::uint32_t>(i), out + count);
+        }
+        return count + findScalar(text, i, size, out + count);
+    }
+#endif
+}
+
+RecordScanner::RecordScanner(const InstructionSet instructionSet) : instructionSet(instructionSet)
+{
+    if (!isSupported(instructionSet))
+        throw std::invalid_argument("Error: Instruction set not supported by this CPU");
+}
+
+RecordScanner::InstructionSet RecordScanner::best()
+{
+    static const InstructionSet detected = isSupported(InstructionSet::AVX2) ? InstructionSet::AVX2
+                                           : isSupported(InstructionSet::SSE2) ? InstructionSet::SSE2
+                                           : InstructionSet::SCALAR;
+    return detected;
+}
+
+bool RecordScanner::isSupported(const InstructionSet instructionSet)
+{
+    switch (instructionSet)
+    {
+#ifdef RECORDSCANNER_X86
+    case InstructionSet::AVX2:
+        return __builtin_cpu_supports("avx2");
+    case InstructionSet::SSE2:
+        return __builtin_cpu_supports("sse2");
+#endif
+    case InstructionSet::SCALAR:
+        return true;
+    default:
+        return false;
+    }
+}
+
+RecordScanner::InstructionSet RecordScanner::getInstructionSet() const
+{
+    return instructionSet;
+}
+
+std::size_t RecordScanner::findDelimiters(const std::string_view text, std::uint32_t* delimiters) const
+{
+    switch (instructionSet)
+    {
+#ifdef RECORDSCANNER_X86
+    case InstructionSet::AVX2:
+        return findAvx2(text.data(), text.size(), delimiters);
+    case InstructionSet::SSE2:
+        return findSse2(text.data(), text.size(), delimiters);
+#endif
+    default:
+        return findScalar(text.data(), 0, text.size(), delimiters);
+    }
+}
+
+bool RecordScanner::parseShortNumber(const std::string_view field, unsigned int& value)
+{
+    if constexpr (std::endian::native != std::endian::little)
+        return false;
+
+    // The field's first 8 bytes, first byte lowest; bytes past its end are 0, never digits
+    std::uint64_t bytes = 0;
+    if (field.size() >= 8)
+        std::memcpy(&bytes, field.data(), 8);
+    else
+        for (std::size_t i = 0; i < field.size(); ++i)
+            bytes |= static_cast<std::uint64_t>(static_cast<unsigned char>(field[i])) << (8 * i);
+
+    // A byte b is a digit iff neither b - '0' nor b + ('\x80' - ':') sets its top bit. Borrows and
+    // carries only move upward, out of non-digits, so the lowest flagged byte is the first non-digit.
+    const std::uint64_t digitValues = bytes - 0x3030303030303030;
+    const std::uint64_t nonDigits = (digitValues | (bytes + 0x4646464646464646)) & 0x8080808080808080;
+    const int digits = std::countr_zero(nonDigits) / 8;
+
+    if (digits == 0 || (digits == 8 && field.size() > 8 && field[8] >= '0' && field[8] <= '9'))
+        return false;
+
+    // Left-pad to 8 digits with zeros, then combine pairs, quads and the two halves by multiplication
+    std::uint64_t number = digitValues << (8 * (8 - digits));
+    number = number * 10 + (number >> 8);
+    number = ((number & 0x000000FF000000FF) * (100 + (1000000ULL << 32)) +
+              ((number >> 16) & 0x000000FF000000FF) * (1 + (10000ULL << 32))) >> 32;
+    value = static_cast<unsigned int>(number);
+    return true;
+}
@@ -0,0 +1,74 @@
+#ifndef RECORDSCANNER_H
+#define RECORDSCANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/**
+ * Finds the field and record delimiters (tabs and newlines) of the input files a block at a time,
+ * comparing 16 or 32 bytes per instruction where the CPU allows it. The instruction set is chosen
+ * at runtime, so one build runs everywhere and uses AVX2 where it is available.
+ * It only splits; <i>Parser</i> validates the fields.
+ */
+class RecordScanner
+{
+public:
+    /**
+     * Instruction sets a scanner can use, slowest first.
+     */
+    enum class InstructionSet { SCALAR, SSE2, AVX2 };
+
+private:
+    InstructionSet instructionSet;
+
+public:
+    /**
+     * Creates a scanner.
+     * @param instructionSet The instruction set to use, the best supported one by default.
+     * @throws std::invalid_argument If the CPU does not support <i>instructionSet</i>.
+     */
+    explicit RecordScanner(InstructionSet instructionSet = best());
+    ~RecordScanner() = default;
+    RecordScanner(const RecordScanner& other) = default;
+    RecordScanner(RecordScanner&& other) noexcept = default;
+    RecordScanner& operator=(const RecordScanner& other) = default;
+    RecordScanner& operator=(RecordScanner&& other) noexcept = default;
+
+    /**
+     * @return The fastest instruction set the running CPU supports.
+     */
+    static InstructionSet best();
+
+    /**
+     * @param instructionSet An instruction set.
+     * @return <i>true</i> if the running CPU, and this build, support it.
+     */
+    static bool isSupported(InstructionSet instructionSet);
+
+    /**
+     * @return The instruction set this scanner uses.
+     */
+    InstructionSet getInstructionSet() const;
+
+    /**
+     * Finds every tab and newline in <i>text</i>.
+     * @param text The block to scan, shorter than 4 GiB.
+     * @param delimiters Output parameter with room for <i>text.size()</i> entries: the offsets of the
+     * delimiters in <i>text</i>, ascending.
+     * @return The number of delimiters found.
+     */
+    std::size_t findDelimiters(std::string_view text, std::uint32_t* delimiters) const;
+
+    /**
+     * Parses a field that starts with a run of at most 8 decimal digits, the usual hop time, without
+     * a branch per digit: the first 8 bytes are tested and converted as one 64-bit word.
+     * @param field The field.
+     * @param value Output parameter for the number, set only on success.
+     * @return <i>false</i>, leaving the field to a general parser, if it does not start with a digit
+     * or starts with more than 8 of them.
+     */
+    static bool parseShortNumber(std::string_view field, unsigned int& value);
+};
+
+#endif //RECORDSCANNER_H
@@ -0,0 +1,40 @@
+#include "ShortestPathTree.h"
+
+#include <algorithm>
+
+int ShortestPathTree::getSource() const
+{
+    return source;
+}
+
+std::uint64_t ShortestPathTree::timeTo(const int vertex) const
+{
+    return times[vertex];
+}
+
+int ShortestPathTree::parentOf(const int vertex) const
+{
+    return parents[vertex];
+}
+
+std::vector<int> ShortestPathTree::routeTo(const int vertex) const
+{
+    std::vector<int> route;
+    if (times[vertex] == UNREACHABLE)
+        return route;
+
+    for (int v = vertex; v != -1; v = parents[v])
+        route.push_back(v);
+    std::reverse(route.begin(), route.end());
+    return route;
+}
+
+const std::vector<std::uint64_t>& ShortestPathTree::getTimes() const
+{
+    return times;
+}
+
+const std::vector<int>& ShortestPathTree::getParents() const
+{
+    return parents;
+}
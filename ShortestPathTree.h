@@ -0,0 +1,81 @@
+#ifndef SHORTESTPATHTREE_H
+#define SHORTESTPATHTREE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+#include "Dijkstra.h"
+#include "RadixHeap.h"
+
+/**
+ * Shortest travel times from one source vertex, with the shortest-path tree as a parent array.
+ * Built by Dijkstra's algorithm over a <i>RadixHeap</i>, for graphs with unsigned integer weights.
+ */
+class ShortestPathTree
+{
+private:
+    int source{-1};
+    std::vector<std::uint64_t> times; /* times[v]: shortest travel time to v, UNREACHABLE if none */
+    std::vector<int> parents; /* parents[v]: the vertex before v on its shortest route, -1 for the source and unreached */
+
+public:
+    static constexpr std::uint64_t UNREACHABLE = std::numeric_limits<std::uint64_t>::max();
+
+    ShortestPathTree() = default;
+    ~ShortestPathTree() = default;
+    ShortestPathTree(const ShortestPathTree& other) = default;
+    ShortestPathTree(ShortestPathTree&& other) noexcept = default;
+    ShortestPathTree& operator=(const ShortestPathTree& other) = default;
+    ShortestPathTree& operator=(ShortestPathTree&& other) noexcept = default;
+
+    /**
+     * Runs Dijkstra's algorithm from <i>source</i>.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>
+     * with unsigned integer weights.
+     * @param graph The graph to search.
+     * @param source A valid vertex index.
+     * @param target A vertex index to stop at once it is settled, or -1 to settle every vertex.
+     * When stopping early, only the route to <i>target</i> and its ancestors is final.
+     */
+    template <class GraphType>
+    ShortestPathTree(const GraphType& graph, int source, int target = -1);
+
+    int getSource() const;
+
+    /**
+     * @param vertex A valid vertex index.
+     * @return The shortest travel time from the source to <i>vertex</i>, <i>UNREACHABLE</i> if there is no route.
+     */
+    std::uint64_t timeTo(int vertex) const;
+
+    /**
+     * @param vertex A valid vertex index.
+     * @return The vertex before <i>vertex</i> on its shortest route, -1 for the source and unreached vertices.
+     */
+    int parentOf(int vertex) const;
+
+    /**
+     * Follows the parent array back from <i>vertex</i>.
+     * @param vertex A valid vertex index.
+     * @return Vertex indexes from the source to <i>vertex</i>, empty if <i>vertex</i> is unreachable.
+     */
+    std::vector<int> routeTo(int vertex) const;
+
+    const std::vector<std::uint64_t>& getTimes() const;
+
+    const std::vector<int>& getParents() const;
+};
+
+template <class GraphType>
+ShortestPathTree::ShortestPathTree(const GraphType& graph, const int source, const int target) :
+    source(source), times(graph.vertexCount(), UNREACHABLE), parents(graph.vertexCount(), -1)
+{
+    RadixHeap queue;
+    dijkstra(graph, source, queue,
+             [&](const int vertex) -> std::uint64_t& { return times[vertex]; },
+             [&](const int vertex, std::uint64_t) { return vertex != target; },
+             [&](const int vertex, const int parent) { parents[vertex] = parent; });
+}
+
+#endif //SHORTESTPATHTREE_H
@@ -0,0 +1,15 @@
+#include "StaleFlag.h"
+
+StaleFlag::StaleFlag(const StaleFlag& other) noexcept : stale(other.stale.load())
+{}
+
+StaleFlag& StaleFlag::operator=(const StaleFlag& other) noexcept
+{
+    stale.store(other.stale.load());
+    return *this;
+}
+
+void StaleFlag::set()
+{
+    stale.store(true, std::memory_order_release);
+}
@@ -0,0 +1,52 @@
+#ifndef STALEFLAG_H
+#define STALEFLAG_H
+
+#include <atomic>
+#include <mutex>
+
+/**
+ * Marks a cache as stale after a change, for caches that const lookups rebuild lazily.
+ * <i>refresh</i> lets exactly one of several concurrent lookups rebuild, while the others wait,
+ * and costs one atomic load once the cache is up to date.
+ * Copies take the state but not the lock, so the owner stays copyable.
+ */
+class StaleFlag
+{
+private:
+    std::atomic<bool> stale{false};
+    std::mutex rebuilding; /* Held while the cache is rebuilt */
+
+public:
+    StaleFlag() = default;
+    ~StaleFlag() = default;
+    StaleFlag(const StaleFlag& other) noexcept;
+    StaleFlag& operator=(const StaleFlag& other) noexcept;
+
+    /**
+     * Marks the cache stale. Only from a non-const change, never concurrently with <i>refresh</i>.
+     */
+    void set();
+
+    /**
+     * Calls <i>rebuild()</i> if the cache is stale, then marks it up to date. Safe to call concurrently.
+     * @param rebuild Callable rebuilding the cache.
+     */
+    template <class Rebuild>
+    void refresh(Rebuild&& rebuild);
+};
+
+template <class Rebuild>
+void StaleFlag::refresh(Rebuild&& rebuild)
+{
+    if (!stale.load(std::memory_order_acquire))
+        return;
+
+    const std::lock_guard guard(rebuilding);
+    if (!stale.load(std::memory_order_relaxed)) // Rebuilt by another caller while this one waited
+        return;
+
+    rebuild();
+    stale.store(false, std::memory_order_release);
+}
+
+#endif //STALEFLAG_H
@@ -0,0 +1,105 @@
+#include "StronglyConnectedComponents.h"
+
+#include <algorithm>
+#include <utility>
+
+StronglyConnectedComponents::StronglyConnectedComponents(const std::vector<int>& offsets,
+                                                         const std::vector<int>& adjacency)
+{
+    const int size = static_cast<int>(offsets.size()) - 1;
+
+    std::vector<int> order(size, -1); /* Discovery order, -1 if undiscovered */
+    std::vector<int> lowLink(size, 0);
+    std::vector<bool> onStack(size, false);
+    std::vector<int> stack;
+    std::vector<std::pair<int, int>> frames; /* A vertex, and a cursor to its next out-edge */
+    int discovered = 0;
+    int componentCount = 0;
+
+    components.assign(size, -1);
+
+    for (int root = 0; root < size; ++root)
+    {
+        if (order[root] != -1)
+            continue;
+
+        order[root] = lowLink[root] = discovered++;
+        stack.push_back(root);
+        onStack[root] = true;
+        frames.emplace_back(root, offsets[root]);
+
+        while (!frames.empty())
+        {
+            auto& [v, cursor] = frames.back();
+
+            if (cursor < offsets[v + 1])
+            {
+                const int w = adjacency[cursor++];
+                if (order[w] == -1)
+                {
+                    order[w] = lowLink[w] = discovered++;
+                    stack.push_back(w);
+                    onStack[w] = true;
+                    frames.emplace_back(w, offsets[w]); // Invalidates v and cursor
+                }
+                else if (onStack[w])
+                    lowLink[v] = std::min(lowLink[v], order[w]);
+                continue;
+            }
+
+            const int finished = v;
+            frames.pop_back();
+
+            if (lowLink[finished] == order[finished])
+            {
+                int member;
+                do
+                {
+                    member = stack.back();
+                    stack.pop_back();
+                    onStack[member] = false;
+                    components[member] = componentCount;
+                } while (member != finished);
+                ++componentCount;
+            }
+
+            if (!frames.empty())
+            {
+                const int parent = frames.back().first;
+                lowLink[parent] = std::min(lowLink[parent], lowLink[finished]);
+            }
+        }
+    }
+
+    // Group the vertices by component, by counting sort
+    memberOffsets.assign(componentCount + 1, 0);
+    for (const int component : components)
+        ++memberOffsets[component + 1];
+    for (int c = 0; c < componentCount; ++c)
+        memberOffsets[c + 1] += memberOffsets[c];
+
+    members.resize(size);
+    std::vector<int> next(memberOffsets.begin(), memberOffsets.end() - 1);
+    for (int v = 0; v < size; ++v)
+        members[next[components[v]]++] = v;
+}
+
+int StronglyConnectedComponents::vertexCount() const
+{
+    return static_cast<int>(components.size());
+}
+
+int StronglyConnectedComponents::componentCount() const
+{
+    return memberOffsets.empty() ? 0 : static_cast<int>(memberOffsets.size()) - 1;
+}
+
+int StronglyConnectedComponents::componentOf(const int vertex) const
+{
+    return components[vertex];
+}
+
+std::size_t StronglyConnectedComponents::memoryUsage() const
+{
+    return (components.capacity() + memberOffsets.capacity() + members.capacity()) * sizeof(int);
+}
@@ -0,0 +1,71 @@
+#ifndef STRONGLYCONNECTEDCOMPONENTS_H
+#define STRONGLYCONNECTEDCOMPONENTS_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * The strongly connected components (SCCs) of a graph, found by an iterative Tarjan search.
+ * Components are numbered in the order they complete, which is reverse topological order:
+ * every edge between two components goes from a higher id to a lower one.
+ */
+class StronglyConnectedComponents
+{
+private:
+    std::vector<int> components; /* components[v]: the SCC of vertex v */
+    std::vector<int> memberOffsets; /* Start of each component's vertices in members, plus a trailing end offset */
+    std::vector<int> members; /* Vertex indexes, grouped by component, ascending within a component */
+
+public:
+    StronglyConnectedComponents() = default;
+    ~StronglyConnectedComponents() = default;
+    StronglyConnectedComponents(const StronglyConnectedComponents& other) = default;
+    StronglyConnectedComponents(StronglyConnectedComponents&& other) noexcept = default;
+    StronglyConnectedComponents& operator=(const StronglyConnectedComponents& other) = default;
+    StronglyConnectedComponents& operator=(StronglyConnectedComponents&& other) noexcept = default;
+
+    /**
+     * Finds the components of a graph given by its out-edges in CSR form, in O(V + E).
+     * @param offsets Start of each vertex's out-edges in <i>adjacency</i>, plus a trailing end offset.
+     * @param adjacency Out-edge targets, grouped by source.
+     */
+    StronglyConnectedComponents(const std::vector<int>& offsets, const std::vector<int>& adjacency);
+
+    /**
+     * @return The number of vertices.
+     */
+    int vertexCount() const;
+
+    /**
+     * @return The number of components.
+     */
+    int componentCount() const;
+
+    /**
+     * @param vertex A valid vertex index.
+     * @return The component of <i>vertex</i>.
+     */
+    int componentOf(int vertex) const;
+
+    /**
+     * Calls <i>visit(vertexIndex)</i> for every vertex of <i>component</i>, by ascending index.
+     * @param component A valid component id.
+     * @param visit Callable taking <i>(int)</i>.
+     */
+    template <class Visitor>
+    void forEachMember(int component, Visitor&& visit) const;
+
+    /**
+     * @return Bytes held by the components.
+     */
+    std::size_t memoryUsage() const;
+};
+
+template <class Visitor>
+void StronglyConnectedComponents::forEachMember(const int component, Visitor&& visit) const
+{
+    for (int m = memberOffsets[component]; m < memberOffsets[component + 1]; ++m)
+        visit(members[m]);
+}
+
+#endif //STRONGLYCONNECTEDCOMPONENTS_H
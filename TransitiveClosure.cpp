@@ -0,0 +1,85 @@
+#include "TransitiveClosure.h"
+
+#include <algorithm>
+#include <bit>
+#include <utility>
+
+void TransitiveClosure::build(const CsrGraph& graph)
+{
+    const std::vector<int>& offsets = graph.offsets;
+    const std::vector<int>& adjacency = graph.adjacency;
+    sccs = StronglyConnectedComponents(offsets, adjacency);
+    const int size = sccs.vertexCount();
+
+    wordsPerRow = (size + 63) / 64;
+    rows.assign(sccs.componentCount() * wordsPerRow, 0);
+
+    for (int v = 0; v < size; ++v)
+        rows[sccs.componentOf(v) * wordsPerRow + v / 64] |= std::uint64_t{1} << (v % 64);
+
+    // Distinct edges of the condensation, grouped by source component
+    std::vector<std::pair<int, int>> dag;
+    dag.reserve(adjacency.size());
+    for (int v = 0; v < size; ++v)
+    {
+        for (int e = offsets[v]; e < offsets[v + 1]; ++e)
+        {
+            const int from = sccs.componentOf(v);
+            const int to = sccs.componentOf(adjacency[e]);
+            if (from != to)
+                dag.emplace_back(from, to);
+        }
+    }
+    std::sort(dag.begin(), dag.end());
+    dag.erase(std::unique(dag.begin(), dag.end()), dag.end());
+
+    // Successors have lower ids, so their rows are complete when OR-ed in.
+    // The sorted edge list visits source components in ascending order too.
+    for (const auto& [component, successor] : dag)
+    {
+        std::uint64_t* row = rows.data() + component * wordsPerRow;
+        const std::uint64_t* successorRow = rows.data() + successor * wordsPerRow;
+        for (std::size_t w = 0; w < wordsPerRow; ++w)
+            row[w] |= successorRow[w];
+    }
+}
+
+int TransitiveClosure::vertexCount() const
+{
+    return sccs.vertexCount();
+}
+
+bool TransitiveClosure::isReachable(const int from, const int to) const
+{
+    if (from == to)
+        return false;
+    const std::uint64_t word = rows[sccs.componentOf(from) * wordsPerRow + to / 64];
+    return (word >> (to % 64)) & 1;
+}
+
+std::vector<int> TransitiveClosure::reachableFrom(const int vertex) const
+{
+    const std::uint64_t* row = rows.data() + sccs.componentOf(vertex) * wordsPerRow;
+
+    std::vector<int> result;
+    for (std::size_t w = 0; w < wordsPerRow; ++w)
+    {
+        for (std::uint64_t word = row[w]; word != 0; word &= word - 1)
+        {
+            const int reached = static_cast<int>(w * 64 + std::countr_zero(word));
+            if (reached != vertex)
+                result.push_back(reached);
+        }
+    }
+    return result;
+}
+
+std::size_t TransitiveClosure::memoryUsage() const
+{
+    return rows.capacity() * sizeof(std::uint64_t) + sccs.memoryUsage();
+}
+
+std::chrono::microseconds TransitiveClosure::getBuildTime() const
+{
+    return buildTime;
+}
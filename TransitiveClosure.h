@@ -0,0 +1,93 @@
+#ifndef TRANSITIVECLOSURE_H
+#define TRANSITIVECLOSURE_H
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CsrGraph.h"
+#include "StronglyConnectedComponents.h"
+
+/**
+ * Precomputed transitive closure of a graph, stored as packed 64-bit bitsets.
+ * Vertices of one strongly connected component reach the same vertices, so there is one
+ * row per component, not per vertex: bit <i>v</i> of a component's row is set iff the component
+ * reaches vertex <i>v</i>. Rows are built in reverse topological order, each one the word-wise OR
+ * of its successors' rows, so a reachability test is a single bit test.
+ * Memory is <i>componentCount * ceil(V / 64) * 8</i> bytes; see <i>memoryUsage()</i>.
+ * The closure is a snapshot: it does not follow later changes to the graph.
+ */
+class TransitiveClosure
+{
+private:
+    StronglyConnectedComponents sccs; /* The component of a vertex is its row */
+    std::size_t wordsPerRow{0};
+    std::vector<std::uint64_t> rows; /* componentCount rows of wordsPerRow words each */
+    std::chrono::microseconds buildTime{0};
+
+    /**
+     * Builds the rows from the graph's out-edges in CSR form.
+     */
+    void build(const CsrGraph& graph);
+
+public:
+    TransitiveClosure() = default;
+    ~TransitiveClosure() = default;
+    TransitiveClosure(const TransitiveClosure& other) = default;
+    TransitiveClosure(TransitiveClosure&& other) noexcept = default;
+    TransitiveClosure& operator=(const TransitiveClosure& other) = default;
+    TransitiveClosure& operator=(TransitiveClosure&& other) noexcept = default;
+
+    /**
+     * Builds the closure of <i>graph</i>.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>.
+     * @param graph The graph to index.
+     */
+    template <class GraphType>
+    explicit TransitiveClosure(const GraphType& graph);
+
+    /**
+     * @return The number of indexed vertices.
+     */
+    int vertexCount() const;
+
+    /**
+     * Checks whether <i>to</i> is among the vertices a BFS from <i>from</i> reaches,
+     * <i>from</i> itself excluded.
+     * @param from A valid vertex index.
+     * @param to A valid vertex index.
+     * @return <i>true</i> if <i>from != to</i> and a path leads from <i>from</i> to <i>to</i>.
+     */
+    bool isReachable(int from, int to) const;
+
+    /**
+     * Retrieves every vertex reachable from <i>vertex</i>, other than <i>vertex</i> itself,
+     * by scanning its row.
+     * @param vertex A valid vertex index.
+     * @return The reachable vertex indexes, ascending.
+     */
+    std::vector<int> reachableFrom(int vertex) const;
+
+    /**
+     * @return Bytes held by the closure.
+     */
+    std::size_t memoryUsage() const;
+
+    /**
+     * @return Time it took to build the closure, components included.
+     */
+    std::chrono::microseconds getBuildTime() const;
+};
+
+template <class GraphType>
+TransitiveClosure::TransitiveClosure(const GraphType& graph)
+{
+    const auto begin = std::chrono::steady_clock::now();
+
+    build(CsrGraph::outEdges<false>(graph));
+
+    buildTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin);
+}
+
+#endif //TRANSITIVECLOSURE_H
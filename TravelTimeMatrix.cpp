@@ -0,0 +1,224 @@
+#include "TravelTimeMatrix.h"
+
+#include <algorithm>
+#include <atomic>
+#include <barrier>
+#include <thread>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+#include "Dijkstra.h"
+#include "RadixHeap.h"
+#include "ShortestPathTree.h"
+
+namespace
+{
+    /* Floyd-Warshall wins once vertices average more than 1 / DENSE_FRACTION of the vertices as neighbors */
+    constexpr std::size_t DENSE_FRACTION = 8;
+
+    /**
+     * Runs <i>worker()</i> on <i>threadCount</i> threads, the calling thread included, and waits for them.
+     */
+    template <class Worker>
+    void runWorkers(const unsigned int threadCount, const Worker& worker)
+    {
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < std::max(1u, threadCount); ++t)
+            threads.emplace_back(worker);
+        worker();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    /**
+     * One tile row: <i>cRow[j] = min(cRow[j], viaK + bRow[j])</i>. No overflow checks: two sentinels
+     * still fit in 32 bits. SSE2 (part of every x86-64 CPU) does four columns at a time; it has no
+     * unsigned 32-bit compare, so both sides are biased by the sign bit and compared as signed.
+     */
+    void relaxRow(std::uint32_t* cRow, const std::uint32_t* bRow, const std::uint32_t viaK)
+    {
+#ifdef __SSE2__
+        const __m128i via = _mm_set1_epi32(static_cast<int>(viaK));
+        const __m128i bias = _mm_set1_epi32(static_cast<int>(0x80000000u));
+        for (int j = 0; j < TravelTimeMatrix::TILE; j += 4)
+        {
+            const __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cRow + j));
+            const __m128i candidate = _mm_add_epi32(via, _mm_loadu_si128(reinterpret_cast<const __m128i*>(bRow + j)));
+            const __m128i shorter = _mm_cmpgt_epi32(_mm_xor_si128(current, bias), _mm_xor_si128(candidate, bias));
+            const __m128i result = _mm_or_si128(_mm_and_si128(shorter, candidate), _mm_andnot_si128(shorter, current));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(cRow + j), result);
+        }
+#else
+        for (int j = 0; j < TravelTimeMatrix::TILE; ++j)
+            cRow[j] = std::min(cRow[j], viaK + bRow[j]);
+#endif
+    }
+
+    /**
+     * Relaxes tile <i>c</i> through the vertices of one tile: <i>c[i][j] = min(c[i][j], a[i][k] + b[k][j])</i>.
+     * <i>k</i> is the outer loop, so <i>c</i> may be the same tile as <i>a</i> or <i>b</i>.
+     */
+    void relaxTile(std::uint32_t* c, const std::uint32_t* a, const std::uint32_t* b, const std::size_t stride)
+    {
+        for (int k = 0; k < TravelTimeMatrix::TILE; ++k)
+        {
+            const std::uint32_t* bRow = b + k * stride;
+            for (int i = 0; i < TravelTimeMatrix::TILE; ++i)
+            {
+                const std::uint32_t viaK = a[i * stride + k];
+                if (viaK == TravelTimeMatrix::UNREACHABLE)
+                    continue;
+
+                relaxRow(c + i * stride, bRow, viaK);
+            }
+        }
+    }
+}
+
+void TravelTimeMatrix::build(const CsrGraph& graph, const unsigned int threadCount, Method method)
+{
+    size = graph.vertexCount();
+    stride = (static_cast<std::size_t>(size) + TILE - 1) / TILE * TILE;
+    times.assign(stride * stride, UNREACHABLE);
+    for (std::size_t v = 0; v < stride; ++v)
+        times[v * stride + v] = 0;
+
+    if (method == Method::AUTO)
+    {
+        const bool sparse = graph.adjacency.size() * DENSE_FRACTION < static_cast<std::size_t>(size) * size;
+        method = sparse ? Method::DIJKSTRA : Method::FLOYD_WARSHALL;
+    }
+
+    if (method == Method::DIJKSTRA)
+    {
+        repeatedDijkstra(graph, threadCount);
+        return;
+    }
+
+    for (int u = 0; u < size; ++u)
+    {
+        graph.forEachOutEdge(u, [&](const int neighbor, const std::uint64_t weight)
+        {
+            std::uint32_t& cell = times[u * stride + neighbor];
+            cell = static_cast<std::uint32_t>(std::min<std::uint64_t>(cell, weight));
+        });
+    }
+    floydWarshall(threadCount);
+}
+
+void TravelTimeMatrix::floydWarshall(const unsigned int threadCount)
+{
+    const int tiles = static_cast<int>(stride / TILE);
+    if (tiles == 0)
+        return;
+    const auto tile = [&](const int row, const int column)
+    {
+        return times.data() + row * TILE * stride + column * TILE;
+    };
+
+    // Each round has three phases, each reading what the one before wrote: the diagonal tile, then
+    // its row and column through it, then the rest through those. One set of workers runs every
+    // phase of every round, claiming tasks from next; the barrier's completion step moves them all
+    // on to the next phase.
+    int round = 0;
+    int phase = 0;
+    std::atomic<int> next{0};
+
+    const auto taskCount = [&]()
+    {
+        return phase == 0 ? 1 : phase == 1 ? 2 * tiles : tiles;
+    };
+    const auto runTask = [&](const int task)
+    {
+        std::uint32_t* diagonal = tile(round, round);
+        if (phase == 0)
+        {
+            relaxTile(diagonal, diagonal, diagonal, stride);
+        }
+        else if (phase == 1)
+        {
+            // Tasks 2 * other and 2 * other + 1: the row tile and the column tile of other
+            const int other = task / 2;
+            if (other == round)
+                return;
+            if (task % 2 == 0)
+                relaxTile(tile(round, other), diagonal, tile(round, other), stride);
+            else
+                relaxTile(tile(other, round), tile(other, round), diagonal, stride);
+        }
+        else if (task != round)
+        {
+            for (int column = 0; column < tiles; ++column)
+            {
+                if (column != round)
+                    relaxTile(tile(task, column), tile(task, round), tile(round, column), stride);
+            }
+        }
+    };
+
+    const auto endPhase = [&]() noexcept
+    {
+        if (++phase == 3)
+        {
+            phase = 0;
+            ++round;
+        }
+        next.store(0, std::memory_order_relaxed);
+    };
+    const unsigned int workers = std::clamp(threadCount, 1u, static_cast<unsigned int>(2 * tiles));
+    std::barrier phaseEnd(static_cast<std::ptrdiff_t>(workers), endPhase);
+
+    runWorkers(workers, [&]()
+    {
+        while (round < tiles)
+        {
+            for (int task = next++; task < taskCount(); task = next++)
+                runTask(task);
+            phaseEnd.arrive_and_wait();
+        }
+    });
+}
+
+void TravelTimeMatrix::repeatedDijkstra(const CsrGraph& graph, const unsigned int threadCount)
+{
+    std::atomic<int> next{0};
+    runWorkers(threadCount, [&]()
+    {
+        RadixHeap queue;
+        std::vector<std::uint64_t> sourceTimes(size);
+        for (int source = next++; source < size; source = next++)
+        {
+            std::fill(sourceTimes.begin(), sourceTimes.end(), ShortestPathTree::UNREACHABLE);
+            dijkstra(graph, source, queue,
+                     [&](const int vertex) -> std::uint64_t& { return sourceTimes[vertex]; },
+                     [](int, std::uint64_t) { return true; },
+                     [](int, int) {});
+
+            std::uint32_t* sourceRow = times.data() + source * stride;
+            for (int v = 0; v < size; ++v)
+                sourceRow[v] = static_cast<std::uint32_t>(std::min<std::uint64_t>(sourceTimes[v], UNREACHABLE));
+        }
+    });
+}
+
+int TravelTimeMatrix::vertexCount() const
+{
+    return size;
+}
+
+std::uint32_t TravelTimeMatrix::timeAt(const int from, const int to) const
+{
+    return times[from * stride + to];
+}
+
+const std::uint32_t* TravelTimeMatrix::row(const int from) const
+{
+    return times.data() + from * stride;
+}
+
+std::size_t TravelTimeMatrix::memoryUsage() const
+{
+    return times.size() * sizeof(std::uint32_t);
+}
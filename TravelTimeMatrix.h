@@ -0,0 +1,103 @@
+#ifndef TRAVELTIMEMATRIX_H
+#define TRAVELTIMEMATRIX_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "CsrGraph.h"
+
+/**
+ * Shortest travel time between every pair of vertices, as a flat row-major <i>uint32</i> matrix,
+ * for graphs with unsigned integer weights.
+ * Dense graphs are solved by blocked Floyd-Warshall: the matrix is cut into <i>TILE x TILE</i>
+ * tiles that fit in L1/L2 cache, and each round relaxes the diagonal tile, then its row and
+ * column, then every other tile. The row and column tiles, and then the rows of other tiles, are
+ * spread over one set of threads kept for all rounds. The inner loop is a branch-free min/add over
+ * contiguous rows, which the compiler vectorizes.
+ * Sparse graphs, such as transit networks, are solved by one Dijkstra run per source instead,
+ * sources spread over threads.
+ * <i>UNREACHABLE</i> is its own sentinel, not <i>Weight()</i>: the sum of two sentinels still
+ * fits in 32 bits, so the kernel needs no overflow checks. Times of <i>UNREACHABLE</i> or more
+ * read as unreachable.
+ */
+class TravelTimeMatrix
+{
+public:
+    static constexpr std::uint32_t UNREACHABLE = 0x7FFFFFFF;
+    static constexpr int TILE = 64; /* 16 KB per tile of uint32 */
+
+    enum class Method
+    {
+        AUTO, /* Dijkstra if the graph is sparse, Floyd-Warshall otherwise */
+        FLOYD_WARSHALL,
+        DIJKSTRA
+    };
+
+private:
+    int size{0};
+    std::size_t stride{0}; /* Row length of times: size rounded up to a whole tile */
+    std::vector<std::uint32_t> times; /* times[from * stride + to] */
+
+    /**
+     * Computes the matrix from the graph's out-edges in CSR form.
+     * @param graph The out-edges, with their weights.
+     * @param threadCount Number of threads to use, at least 1.
+     * @param method The algorithm to use.
+     */
+    void build(const CsrGraph& graph, unsigned int threadCount, Method method);
+
+    void floydWarshall(unsigned int threadCount);
+
+    void repeatedDijkstra(const CsrGraph& graph, unsigned int threadCount);
+
+public:
+    TravelTimeMatrix() = default;
+    ~TravelTimeMatrix() = default;
+    TravelTimeMatrix(const TravelTimeMatrix& other) = default;
+    TravelTimeMatrix(TravelTimeMatrix&& other) noexcept = default;
+    TravelTimeMatrix& operator=(const TravelTimeMatrix& other) = default;
+    TravelTimeMatrix& operator=(TravelTimeMatrix&& other) noexcept = default;
+
+    /**
+     * Computes the travel times between all pairs of vertices of <i>graph</i>.
+     * @tparam GraphType Provides <i>vertexCount()</i> and <i>forEachOutEdge(index, visit)</i>
+     * with unsigned integer weights.
+     * @param graph The graph to solve.
+     * @param threadCount Number of threads to use, at least 1.
+     * @param method The algorithm to use; by default chosen from the graph's density.
+     */
+    template <class GraphType>
+    explicit TravelTimeMatrix(const GraphType& graph, unsigned int threadCount = 1, Method method = Method::AUTO);
+
+    /**
+     * @return The number of vertices; the matrix is <i>vertexCount() x vertexCount()</i>.
+     */
+    int vertexCount() const;
+
+    /**
+     * @param from A valid vertex index.
+     * @param to A valid vertex index.
+     * @return The shortest travel time from <i>from</i> to <i>to</i>, <i>UNREACHABLE</i> if none.
+     */
+    std::uint32_t timeAt(int from, int to) const;
+
+    /**
+     * @param from A valid vertex index.
+     * @return The travel times from <i>from</i>, <i>vertexCount()</i> of them by destination index.
+     */
+    const std::uint32_t* row(int from) const;
+
+    /**
+     * @return The size of the matrix, padding included, in bytes.
+     */
+    std::size_t memoryUsage() const;
+};
+
+template <class GraphType>
+TravelTimeMatrix::TravelTimeMatrix(const GraphType& graph, const unsigned int threadCount, const Method method)
+{
+    build(CsrGraph::outEdges(graph), threadCount, method);
+}
+
+#endif //TRAVELTIMEMATRIX_H
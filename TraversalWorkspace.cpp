@@ -0,0 +1,17 @@
+#include "TraversalWorkspace.h"
+
+void TraversalWorkspace::reset(const int vertexCount)
+{
+    visited.reset(vertexCount);
+    if (positions.size() < static_cast<size_t>(vertexCount))
+        positions.resize(vertexCount);
+
+    order.clear();
+    stack.clear();
+}
+
+TraversalWorkspace& TraversalWorkspace::local()
+{
+    thread_local TraversalWorkspace workspace;
+    return workspace;
+}
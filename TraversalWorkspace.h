@@ -0,0 +1,71 @@
+#ifndef TRAVERSALWORKSPACE_H
+#define TRAVERSALWORKSPACE_H
+
+#include <utility>
+#include <vector>
+
+#include "EpochStamps.h"
+
+/**
+ * Scratch buffers for index-based graph traversals, reused across queries so that
+ * a traversal does not allocate once the buffers have grown to the graph's size.
+ * Visited marks are <i>EpochStamps</i>, so starting a traversal does not clear them one by one.
+ */
+class TraversalWorkspace
+{
+private:
+    EpochStamps visited; /* The vertices visited in the current traversal */
+
+public:
+    std::vector<int> order; /* Vertices in the order they were reached; BFS consumes it as its queue */
+    std::vector<std::pair<int, int>> stack; /* DFS frames: a vertex, and a cursor to its next out-edge */
+    std::vector<int> positions; /* positions[v]: index of v in order, valid for visited vertices */
+    std::vector<int> pending; /* Bottom-up BFS: the vertices not visited yet */
+    std::vector<std::pair<int, int>> found; /* Bottom-up BFS: vertices reached in a level, with their parent's position */
+
+    TraversalWorkspace() = default;
+    ~TraversalWorkspace() = default;
+    TraversalWorkspace(const TraversalWorkspace& other) = default;
+    TraversalWorkspace(TraversalWorkspace&& other) noexcept = default;
+    TraversalWorkspace& operator=(const TraversalWorkspace& other) = default;
+    TraversalWorkspace& operator=(TraversalWorkspace&& other) noexcept = default;
+
+    /**
+     * Starts a new traversal over a graph of <i>vertexCount</i> vertices:
+     * marks every vertex unvisited, empties <i>order</i> and <i>stack</i>, and sizes <i>positions</i>.
+     * @param vertexCount Number of vertices in the graph to traverse.
+     */
+    void reset(int vertexCount);
+
+    /**
+     * Marks <i>vertex</i> visited.
+     * @param vertex A vertex index below the count given to <i>reset</i>.
+     * @return <i>true</i> if it was not visited yet in this traversal, <i>false</i> otherwise.
+     */
+    bool markVisited(int vertex);
+
+    /**
+     * @param vertex A vertex index below the count given to <i>reset</i>.
+     * @return <i>true</i> if <i>vertex</i> was visited in this traversal.
+     */
+    bool isVisited(int vertex) const;
+
+    /**
+     * @return The calling thread's workspace.
+     */
+    static TraversalWorkspace& local();
+};
+
+// Called once per examined edge, so defined here where every traversal can inline them
+
+inline bool TraversalWorkspace::markVisited(const int vertex)
+{
+    return visited.mark(vertex);
+}
+
+inline bool TraversalWorkspace::isVisited(const int vertex) const
+{
+    return visited.isMarked(vertex);
+}
+
+#endif //TRAVERSALWORKSPACE_H
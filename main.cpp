@@ -1,11 +1,12 @@
 #include <iostream>
 #include <string>
+#include "CompactGraph.h"
 #include "Graph.h"
 #include "Parser.h"
 
 using namespace std;
 
-void programLoop(const Graph<string, unsigned int>& graph)
+void programLoop(const CompactGraph<string, unsigned int>& graph, const unsigned int threadCount)
 {
     string input;
     do
@@ -18,10 +19,10 @@ void programLoop(const Graph<string, unsigned int>& graph)
 
         try
         {
-            const vector<string> connections = graph.getConnections(input);
+            const vector<string> connections = graph.getConnections(input, true, threadCount);
             if (connections.size() == 0)
             {
-                cout << connections[0] << " : no outbound travel" << endl;
+                cout << input << " : no outbound travel" << endl;
             }
             else
             {
@@ -44,8 +45,10 @@ void programLoop(const Graph<string, unsigned int>& graph)
 
 int main(int argc, char** argv)
 {
-    const Graph<string, unsigned int> graph = Parser(argc, argv).getGraph();
+    Parser parser(argc, argv);
+    const unsigned int threadCount = parser.getThreadCount();
+    const CompactGraph<string, unsigned int> graph = move(parser).getNetwork();
     graph.print();
-    programLoop(graph);
+    programLoop(graph, threadCount);
     return 0;
 }